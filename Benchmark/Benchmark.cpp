@@ -1,38 +1,99 @@
 #include <chrono>
 #include <random>
-#include <boost/lockfree/queue.hpp>
 
 #include "Include/OrderBook/OrderBook.h"
 #include "Include/Util/EventInformation.h"
 #include "Include/OrderGenerator.h"
+#include "Include/Workload.h"
+#include "Include/AllocationCounter.h"
+#include "Include/ProducerBenchmark.h"
+#include "Include/ExchangeBenchmark.h"
+#include "Include/RecoveryBenchmark.h"
+#include "Include/BranchBenchmark.h"
 
-void BenchmarkOrderBook(const BenchmarkParams& params)
+void BenchmarkOrderBook(const BenchmarkParams& params, const Workload& workload, const OrderBookConfig& config)
 {
-    OrderGenerator generator;
-    OrderBook orderbook;
+    // Keep the full audit log on, written as binary records rather than text, to a
+    // journal of this run only
 
+    Journal::Remove("Debug/OrderBook.journal");
+    Journal journal{ "Debug/OrderBook.journal" };
+    OrderBookConfig journaledConfig = config;
+    journaledConfig.journal_ = &journal;
+
+    OrderBook orderbook{ journaledConfig };
+
+    auto startAllocations = AllocationCount();
+    auto startDeallocations = DeallocationCount();
     auto start = std::chrono::high_resolution_clock::now();
 
-    std::thread generateThread(&OrderGenerator::GenerateOrders, &generator, std::ref(params));
-    std::thread processThread(&OrderGenerator::ProcessOrders, &generator, std::ref(orderbook));
+    ReplayWorkload(workload, orderbook, ReplayPace::MaxSpeed, params.batchSize_);
+
+    // Include the time taken to drain the queue, not just to enqueue
 
-    if (generateThread.joinable()) generateThread.join();
-    if (processThread.joinable()) processThread.join();
+    orderbook.Size();
 
     auto end = std::chrono::high_resolution_clock::now();
     auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count();
 
     const auto& bookInfos = orderbook.GetOrderInfos();
+    auto allocations = AllocationCount() - startAllocations;
+    auto deallocations = DeallocationCount() - startDeallocations;
     std::cout << std::format
     (
-        "[!] Benchmark Result: Processed {} random orders in {} ms.", 
-        params.numEvents_, 
-        duration
+        "[!] Benchmark Result ({} levels, {} ids, {}/{} queue, batches of {}): Processed {} random orders in {} ms, {:.2f} allocations and {:.2f} frees per event.",
+        LevelStorageToString(config.levelStorage_),
+        OrderIdMapModeToString(config.orderIdMapMode_),
+        QueueModeToString(config.queue_.mode_),
+        WaitStrategyToString(config.queue_.waitStrategy_),
+        params.batchSize_,
+        params.numEvents_,
+        duration,
+        static_cast<double>(allocations) / params.numEvents_,
+        static_cast<double>(deallocations) / params.numEvents_
     ) << std::endl;
 
+#if defined(ORDERBOOK_LATENCY_TRACE)
+    orderbook.GetLatencyTrace().Dump(std::cout);
+#endif
+
     // orderbook.Display();
 }
 
+void BenchmarkInlineOrderBook(const BenchmarkParams& params, const Workload& workload, const OrderBookConfig& config)
+{
+    Journal::Remove("Debug/OrderBook.journal");
+    Journal journal{ "Debug/OrderBook.journal" };
+    OrderBookConfig journaledConfig = config;
+    journaledConfig.journal_ = &journal;
+
+    InlineOrderBook orderbook{ journaledConfig };
+
+    auto startAllocations = AllocationCount();
+    auto startDeallocations = DeallocationCount();
+    auto start = std::chrono::high_resolution_clock::now();
+
+    // Every request is matched by the time the replay returns
+
+    ReplayWorkload(workload, orderbook, ReplayPace::MaxSpeed);
+
+    auto end = std::chrono::high_resolution_clock::now();
+    auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count();
+
+    auto allocations = AllocationCount() - startAllocations;
+    auto deallocations = DeallocationCount() - startDeallocations;
+    std::cout << std::format
+    (
+        "[!] Benchmark Result ({} levels, {} ids, inline): Processed {} random orders in {} ms, {:.2f} allocations and {:.2f} frees per event.",
+        LevelStorageToString(config.levelStorage_),
+        OrderIdMapModeToString(config.orderIdMapMode_),
+        params.numEvents_,
+        duration,
+        static_cast<double>(allocations) / params.numEvents_,
+        static_cast<double>(deallocations) / params.numEvents_
+    ) << std::endl;
+}
+
 int main()
 {
     int start = std::pow(10, 3);
@@ -40,9 +101,130 @@ int main()
 
     for (int num = start; num <= end; num *= 10)
     {
+        // Every configuration replays the same requests, drawn once per size
+
         auto params = DefaultParams(num);
-        BenchmarkOrderBook(params);
+        const auto workloadPath = std::format("Debug/Workload.{}.bin", num);
+        RecordWorkload(params, workloadPath);
+        const Workload workload{ workloadPath };
+
+        BenchmarkOrderBook(params, workload, OrderBookConfig{ .levelStorage_ = LevelStorage::Map });
+        BenchmarkOrderBook(params, workload, OrderBookConfig{ .levelStorage_ = LevelStorage::Ladder });
+
+        // Ids are drawn from [1, 0.8 * num], so they can be indexed directly
+
+        for (auto waitStrategy : { WaitStrategy::BusySpin, WaitStrategy::Park })
+        {
+            BenchmarkOrderBook(params, workload, OrderBookConfig
+            {
+                .levelStorage_ = LevelStorage::Ladder,
+                .orderIdMapMode_ = OrderIdMapMode::Direct,
+                .maxOrderId_ = static_cast<OrderId>(num),
+                .reservedOrders_ = static_cast<std::size_t>(num),
+                .queue_ = { .mode_ = QueueMode::Spsc, .waitStrategy_ = waitStrategy }
+            });
+        }
+
+        // Same book without the queue, matched on the replaying thread
+
+        BenchmarkInlineOrderBook(params, workload, OrderBookConfig
+        {
+            .levelStorage_ = LevelStorage::Ladder,
+            .orderIdMapMode_ = OrderIdMapMode::Direct,
+            .maxOrderId_ = static_cast<OrderId>(num),
+            .reservedOrders_ = static_cast<std::size_t>(num)
+        });
+
+        // Same book fed in packet-sized bursts
+
+        auto batchedParams = params;
+        batchedParams.batchSize_ = 64;
+        BenchmarkOrderBook(batchedParams, workload, OrderBookConfig
+        {
+            .levelStorage_ = LevelStorage::Ladder,
+            .orderIdMapMode_ = OrderIdMapMode::Direct,
+            .maxOrderId_ = static_cast<OrderId>(num),
+            .reservedOrders_ = static_cast<std::size_t>(num),
+            .queue_ = { .mode_ = QueueMode::Spsc, .waitStrategy_ = WaitStrategy::BusySpin }
+        });
+
+        // Same again with fills, cancels and rejects drained by a report consumer, level
+        // deltas drained by a market data consumer and the top of book republished
+
+        std::size_t reports = 0;
+        ExecutionReportSink sink{ [&reports](std::span<const ExecutionReport> batch) { reports += batch.size(); } };
+
+        std::size_t deltas = 0;
+        MarketDataFeed feed{ [&deltas](std::span<const LevelDelta> batch) { deltas += batch.size(); } };
+
+        BenchmarkOrderBook(batchedParams, workload, OrderBookConfig
+        {
+            .levelStorage_ = LevelStorage::Ladder,
+            .orderIdMapMode_ = OrderIdMapMode::Direct,
+            .maxOrderId_ = static_cast<OrderId>(num),
+            .reservedOrders_ = static_cast<std::size_t>(num),
+            .queue_ = { .mode_ = QueueMode::Spsc, .waitStrategy_ = WaitStrategy::BusySpin },
+            .reportSink_ = &sink,
+            .marketDataFeed_ = &feed,
+            .publishTopOfBook_ = true
+        });
+
+        sink.Flush();
+        feed.Flush();
+        std::cout << std::format("[!] Execution reports published: {}, level deltas published: {}", reports, deltas) << std::endl;
+    }
+
+    // Branches retired by the gateway and matching threads, per level storage
+
+    auto branchParams = DefaultParams(static_cast<int>(std::pow(10, 6)));
+    for (auto levelStorage : { LevelStorage::Map, LevelStorage::Ladder })
+    {
+        BenchmarkBranchMisses(branchParams, OrderBookConfig
+        {
+            .levelStorage_ = levelStorage,
+            .orderIdMapMode_ = OrderIdMapMode::Direct,
+            .maxOrderId_ = static_cast<OrderId>(branchParams.numEvents_),
+            .reservedOrders_ = static_cast<std::size_t>(branchParams.numEvents_),
+            .queue_ = { .mode_ = QueueMode::Spsc, .waitStrategy_ = WaitStrategy::BusySpin }
+        });
     }
 
+    // Scale the number of gateway threads feeding a single book
+
+    auto producerParams = DefaultParams(static_cast<int>(std::pow(10, 6)));
+    for (std::size_t producers = 1; producers <= 16; producers *= 2)
+    {
+        for (auto queueMode : { QueueMode::Locked, QueueMode::Mpsc })
+        {
+            BenchmarkProducers(producerParams, producers, OrderBookConfig
+            {
+                .levelStorage_ = LevelStorage::Ladder,
+                .queue_ = { .mode_ = queueMode, .waitStrategy_ = WaitStrategy::SpinYield }
+            });
+        }
+    }
+
+    // Acknowledge every request to its producer through a completion ring
+
+    for (std::size_t producers = 1; producers <= 4; producers *= 2)
+    {
+        BenchmarkAcknowledgements(producerParams, producers, 256, OrderBookConfig
+        {
+            .levelStorage_ = LevelStorage::Ladder,
+            .queue_ = { .mode_ = QueueMode::Mpsc, .waitStrategy_ = WaitStrategy::SpinYield }
+        });
+    }
+
+    // Scale the matching threads of a multi-symbol exchange, each paired with a
+    // gateway thread, up to half the hardware threads
+
+    const auto maxMatchingThreads = std::max<std::size_t>(std::thread::hardware_concurrency() / 2, 1);
+    for (std::size_t threads = 1; threads <= maxMatchingThreads; threads *= 2)
+        BenchmarkExchange(DefaultParams(static_cast<int>(std::pow(10, 6))), 1'000, threads);
+
+    // Restart a book holding 5M resting orders from a snapshot and a journal tail
+
+    BenchmarkRecovery(5'000'000, 100'000);
+
     return 0;
 }
\ No newline at end of file
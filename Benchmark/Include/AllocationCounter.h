@@ -0,0 +1,8 @@
+#pragma once
+
+#include <cstdint>
+
+// Number of calls made to the global operator new and operator delete since the
+// process started, counted by the replacement operators in AllocationCounter.cpp
+std::uint64_t AllocationCount();
+std::uint64_t DeallocationCount();
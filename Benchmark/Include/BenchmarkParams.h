@@ -12,6 +12,9 @@ struct BenchmarkParams
 	double sideDist_;
 	std::pair<double, double> priceDist_;
 	std::pair<double, double> quantityDist_;
+
+	// Number of orders the gateway thread hands to the book per SubmitBatch call
+	std::size_t batchSize_;
 };
 
 inline BenchmarkParams DefaultParams(int numEvents)
@@ -24,6 +27,7 @@ inline BenchmarkParams DefaultParams(int numEvents)
 		{60, 10, 25, 5},
 		0.5,
 		{1000.0, 100.0},
-		{6.0, 1.0}
+		{6.0, 1.0},
+		1
 	};
 }
\ No newline at end of file
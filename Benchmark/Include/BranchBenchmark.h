@@ -0,0 +1,9 @@
+#pragma once
+
+#include "BenchmarkParams.h"
+#include "Include/OrderBook/OrderBook.h"
+
+// Feeds params.numEvents_ pregenerated orders to a book in batches and reports the
+// branches and branch misses retired per event by the gateway and matching threads,
+// where hardware counters are available
+void BenchmarkBranchMisses(const BenchmarkParams& params, const OrderBookConfig& config);
@@ -0,0 +1,11 @@
+#pragma once
+
+#include <cstddef>
+
+#include "BenchmarkParams.h"
+#include "Include/Exchange/Exchange.h"
+
+// Submits params.numEvents_ orders spread over numSymbols uncorrelated symbols to an
+// Exchange with the given number of pinned matching threads, and reports throughput.
+// Each matching thread gets its own gateway thread, sending only for its symbols
+void BenchmarkExchange(const BenchmarkParams& params, std::size_t numSymbols, std::size_t matchingThreads);
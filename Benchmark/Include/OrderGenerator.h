@@ -1,33 +1,33 @@
 #pragma once
 
-#include <thread>
-#include <chrono>
 #include <random>
-#include <boost/lockfree/queue.hpp>
 
 #include "BenchmarkParams.h"
 #include "Include/Util/EventInformation.h"
 
-class OrderGenerator
+// Sends a single order request to the orderbook, under a producer if given, and
+// returns its ticket
+Ticket SubmitEvent(OrderBook& book, const EventInformation& event, ProducerId producer = 0);
+
+// Draws random order requests from the benchmark parameters' distributions
+
+class EventSampler
 {
 public:
 
-	OrderGenerator();
+	explicit EventSampler(const BenchmarkParams& p);
 
-	OrderGenerator(const OrderGenerator&) = delete;
-	OrderGenerator(OrderGenerator&&) = delete;
-	OrderGenerator& operator=(const OrderGenerator&) = delete;
-	OrderGenerator& operator=(OrderGenerator&&) = delete;
+	// Draws order ids from [firstId, lastId] instead of p.orderIdDist_
+	EventSampler(const BenchmarkParams& p, OrderId firstId, OrderId lastId);
 
-	// Thread entry point to generate orders and push them to the queue
-	void GenerateOrders(const BenchmarkParams& p);
-
-	// Thread entry point to send order requests to the orderbook
-	void ProcessOrders(OrderBook& book);
+	EventInformation operator()(std::default_random_engine& generator);
 
 private:
 
-	boost::lockfree::queue<EventInformation> orderQueue_;
-	std::atomic<bool> done_;
-
-};
\ No newline at end of file
+	std::uniform_int_distribution<OrderId> orderIdDist_;
+	std::discrete_distribution<int> eventTypeDist_;
+	std::discrete_distribution<int> orderTypeDist_;
+	std::bernoulli_distribution sideDist_;
+	std::normal_distribution<double> priceDist_;
+	std::lognormal_distribution<double> quantityDist_;
+};
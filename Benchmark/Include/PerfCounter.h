@@ -0,0 +1,40 @@
+#pragma once
+
+#include <cstdint>
+#include <optional>
+
+// Hardware events which can be counted by a PerfCounter
+
+enum class PerfEvent
+{
+	Branches,
+	BranchMisses,
+};
+
+// User-space hardware event counter for the calling thread and any thread it starts
+// while counting, read through perf_event_open on Linux. Counts of the started
+// threads are only included once they have exited. Unavailable on other platforms,
+// and where the kernel or the virtual machine exposes no hardware counters
+
+class PerfCounter
+{
+public:
+
+	explicit PerfCounter(PerfEvent event);
+	~PerfCounter();
+
+	PerfCounter(const PerfCounter&) = delete;
+	PerfCounter& operator=(const PerfCounter&) = delete;
+
+	bool IsOpen() const { return fd_ >= 0; }
+
+	// Resets the count and starts counting
+	void Start();
+
+	// Stops counting and returns the count, if the counter is available
+	std::optional<std::uint64_t> Stop();
+
+private:
+
+	int fd_{ -1 };
+};
@@ -0,0 +1,17 @@
+#pragma once
+
+#include <cstddef>
+
+#include "BenchmarkParams.h"
+#include "Include/OrderBook/OrderBook.h"
+
+// Submits params.numEvents_ orders to one book from numProducers gateway threads at
+// once, and reports the throughput and the p99 latency of a single enqueue. Each
+// producer draws ids from its own range, so producers never touch each other's orders
+void BenchmarkProducers(const BenchmarkParams& params, std::size_t numProducers, const OrderBookConfig& config);
+
+// Same as BenchmarkProducers, with each producer registered on the book and polling
+// its completion ring between submissions. Reports the p99 latency from queuing a
+// request to its producer taking the completion. Producers keep at most inFlight
+// requests unacknowledged
+void BenchmarkAcknowledgements(const BenchmarkParams& params, std::size_t numProducers, std::size_t inFlight, const OrderBookConfig& config);
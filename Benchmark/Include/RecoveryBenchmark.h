@@ -0,0 +1,10 @@
+#pragma once
+
+#include <cstddef>
+
+#include "Include/OrderBook/OrderBook.h"
+
+// Rests numOrders non-crossing orders on a book, snapshots it, journals a tail of
+// further requests, then reports the time taken to snapshot and to recover a new
+// book from the snapshot and the journal tail
+void BenchmarkRecovery(std::size_t numOrders, std::size_t tailEvents);
@@ -0,0 +1,83 @@
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <span>
+#include <type_traits>
+
+#include "BenchmarkParams.h"
+#include "Include/Util/EventInformation.h"
+#include "Include/Util/MappedFile.h"
+
+// A recorded order request, stamped with its arrival time in nanoseconds from the
+// first request of the workload
+
+struct WorkloadRecord
+{
+	std::uint64_t timestamp_{ };
+	OrderId orderId_{ };
+	Price price_{ };
+	Quantity quantity_{ };
+	EventType eventType_{ };
+	OrderType orderType_{ };
+	Side side_{ };
+};
+
+static_assert(std::is_trivially_copyable_v<WorkloadRecord>);
+static_assert(sizeof(WorkloadRecord) == 32);
+
+// Leads a workload file, followed by recordCount_ records
+
+struct WorkloadHeader
+{
+	static constexpr std::uint64_t Magic = 0x44414F4C'4B524F57; // "WORKLOAD"
+	static constexpr std::uint32_t CurrentVersion = 1;
+
+	std::uint64_t magic_{ Magic };
+	std::uint32_t version_{ CurrentVersion };
+	std::uint32_t recordSize_{ sizeof(WorkloadRecord) };
+	std::uint64_t recordCount_{ };
+	std::uint8_t reserved_[8]{ };
+};
+
+static_assert(sizeof(WorkloadHeader) == 32);
+
+// Draws p.numEvents_ requests from the benchmark parameters' distributions with a
+// fixed seed, arriving as a Poisson process at the given rate, and writes them to
+// path. The same parameters always record the same workload
+
+void RecordWorkload(const BenchmarkParams& p, const std::filesystem::path& path, double eventsPerSecond = 1e6);
+
+// A recorded workload mapped read-only. Throws runtime_error if path is not a
+// workload file of this version
+
+class Workload
+{
+public:
+
+	explicit Workload(const std::filesystem::path& path);
+
+	std::span<const WorkloadRecord> Records() const;
+	std::size_t Size() const { return Records().size(); }
+
+private:
+
+	MappedFile file_;
+};
+
+// How fast a workload is fed to the book
+enum class ReplayPace
+{
+	MaxSpeed,	// As fast as the queue takes requests
+	Recorded,	// Each request at its recorded offset from the start of the replay
+};
+
+// Submits every request of a workload to the book from the calling thread, in
+// batches of up to batchSize requests, and returns once the last one is queued
+
+void ReplayWorkload(const Workload& workload, OrderBook& book, ReplayPace pace, std::size_t batchSize);
+
+// Hands every request of a workload to an inline book from the calling thread, and
+// returns once the last one has been matched
+
+void ReplayWorkload(const Workload& workload, InlineOrderBook& book, ReplayPace pace);
@@ -0,0 +1,44 @@
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+#include "../Include/AllocationCounter.h"
+
+namespace
+{
+	std::atomic<std::uint64_t> allocations{ 0 };
+	std::atomic<std::uint64_t> deallocations{ 0 };
+
+	void* CountedAllocate(std::size_t size)
+	{
+		allocations.fetch_add(1, std::memory_order_relaxed);
+		if (void* memory = std::malloc(size ? size : 1))
+			return memory;
+		throw std::bad_alloc{};
+	}
+
+	void CountedFree(void* memory)
+	{
+		if (!memory) return;
+
+		deallocations.fetch_add(1, std::memory_order_relaxed);
+		std::free(memory);
+	}
+}
+
+std::uint64_t AllocationCount()
+{
+	return allocations.load(std::memory_order_relaxed);
+}
+
+std::uint64_t DeallocationCount()
+{
+	return deallocations.load(std::memory_order_relaxed);
+}
+
+void* operator new(std::size_t size) { return CountedAllocate(size); }
+void* operator new[](std::size_t size) { return CountedAllocate(size); }
+void operator delete(void* memory) noexcept { CountedFree(memory); }
+void operator delete[](void* memory) noexcept { CountedFree(memory); }
+void operator delete(void* memory, std::size_t) noexcept { CountedFree(memory); }
+void operator delete[](void* memory, std::size_t) noexcept { CountedFree(memory); }
@@ -0,0 +1,76 @@
+#include "../Include/BranchBenchmark.h"
+
+#include <algorithm>
+#include <chrono>
+#include <format>
+#include <random>
+#include <vector>
+
+#include "../Include/OrderGenerator.h"
+#include "../Include/PerfCounter.h"
+
+namespace
+{
+	constexpr std::size_t BatchSize = 64;
+}
+
+void BenchmarkBranchMisses(const BenchmarkParams& params, const OrderBookConfig& config)
+{
+	// Pregenerate the events so that sampling them is not counted
+
+	std::default_random_engine generator;
+	EventSampler sampler(params);
+
+	std::vector<QueueEvent> events;
+	events.reserve(params.numEvents_);
+	for (int i = 0; i < params.numEvents_; ++i)
+		events.push_back(ToQueueEvent(sampler(generator)));
+
+	// The journal writer starts before counting, the matching thread starts after
+	// it so that its branches are included once the book has joined it
+
+	Journal::Remove("Debug/OrderBook.journal");
+	Journal journal{ "Debug/OrderBook.journal" };
+	OrderBookConfig journaledConfig = config;
+	journaledConfig.journal_ = &journal;
+
+	PerfCounter branches{ PerfEvent::Branches };
+	PerfCounter branchMisses{ PerfEvent::BranchMisses };
+
+	branches.Start();
+	branchMisses.Start();
+	auto start = std::chrono::steady_clock::now();
+
+	{
+		OrderBook orderbook{ journaledConfig };
+
+		for (std::size_t offset = 0; offset < events.size(); offset += BatchSize)
+		{
+			const auto count = std::min(BatchSize, events.size() - offset);
+			orderbook.SubmitBatch({ events.data() + offset, count });
+		}
+
+		orderbook.Size();
+	}
+
+	auto end = std::chrono::steady_clock::now();
+	const auto branchCount = branches.Stop();
+	const auto branchMissCount = branchMisses.Stop();
+
+	const auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count();
+	const auto perEvent = [&params](std::uint64_t count) { return static_cast<double>(count) / params.numEvents_; };
+
+	const std::string counters = (branchCount && branchMissCount)
+		? std::format("{:.1f} branches and {:.2f} branch misses per event", perEvent(*branchCount), perEvent(*branchMissCount))
+		: std::string{ "branch counters unavailable" };
+
+	std::cout << std::format
+	(
+		"[!] Branch Result ({} levels, {} ids): Processed {} random orders in {} ms, {}.",
+		LevelStorageToString(config.levelStorage_),
+		OrderIdMapModeToString(config.orderIdMapMode_),
+		params.numEvents_,
+		duration,
+		counters
+	) << std::endl;
+}
@@ -0,0 +1,100 @@
+#include "../Include/ExchangeBenchmark.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <numeric>
+#include <random>
+#include <thread>
+
+#include "../Include/OrderGenerator.h"
+
+void BenchmarkExchange(const BenchmarkParams& params, std::size_t numSymbols, std::size_t matchingThreads)
+{
+	// Symbols are dealt to the matching threads in order, so gateway g sends for
+	// the symbols congruent to g
+
+	const int perGateway = params.numEvents_ / static_cast<int>(matchingThreads);
+	const int perSymbol = std::max<int>(params.numEvents_ / static_cast<int>(numSymbols), 1);
+
+	std::vector<std::vector<QueueEvent>> events(matchingThreads);
+	for (std::size_t gateway = 0; gateway < matchingThreads; ++gateway)
+	{
+		std::default_random_engine generator(static_cast<unsigned>(gateway));
+		std::uniform_int_distribution<std::size_t> symbolDist(0, (numSymbols - 1 - gateway) / matchingThreads);
+		EventSampler sampler(params, 1, static_cast<OrderId>(perSymbol * 0.8) + 1);
+
+		events[gateway].reserve(perGateway);
+		for (int i = 0; i < perGateway; ++i)
+		{
+			const auto symbol = static_cast<SymbolId>(gateway + symbolDist(generator) * matchingThreads);
+			events[gateway].push_back(ToQueueEvent(sampler(generator)));
+			events[gateway].back().symbolId_ = symbol;
+		}
+	}
+
+	std::vector<int> cores(matchingThreads);
+	std::iota(cores.begin(), cores.end(), 0);
+
+	// Every book journals to the same file, whatever its matching thread
+
+	Journal::Remove("Debug/Exchange.journal");
+	Journal journal{ "Debug/Exchange.journal" };
+
+	Exchange exchange{ ExchangeConfig
+	{
+		.matchingThreads_ = matchingThreads,
+		.cores_ = cores,
+		.book_ =
+		{
+			.levelStorage_ = LevelStorage::Ladder,
+			.queue_ = { .mode_ = QueueMode::Mpsc, .waitStrategy_ = WaitStrategy::SpinYield },
+			.journal_ = &journal
+		}
+	} };
+
+	for (SymbolId symbol = 0; symbol < numSymbols; ++symbol)
+		exchange.AddSymbol(symbol);
+
+	std::atomic<bool> go{ false };
+	std::vector<std::thread> gateways;
+	for (std::size_t gateway = 0; gateway < matchingThreads; ++gateway)
+	{
+		gateways.emplace_back([&, gateway]()
+		{
+			while (!go.load(std::memory_order_acquire)) {}
+
+			std::span<const QueueEvent> remaining{ events[gateway] };
+			while (!remaining.empty())
+			{
+				const auto batch = remaining.first(std::min<std::size_t>(remaining.size(), 64));
+				exchange.SubmitBatch(batch);
+				remaining = remaining.subspan(batch.size());
+			}
+		});
+	}
+
+	auto start = std::chrono::steady_clock::now();
+	go.store(true, std::memory_order_release);
+
+	for (auto& gateway : gateways)
+		gateway.join();
+
+	// Include the time taken to drain the queues, not just to enqueue
+
+	exchange.WaitForAllEvents();
+
+	auto end = std::chrono::steady_clock::now();
+	auto duration = std::chrono::duration_cast<std::chrono::microseconds>(end - start).count();
+	const auto processed = static_cast<std::size_t>(perGateway) * matchingThreads;
+
+	std::cout << std::format
+	(
+		"[!] Exchange Benchmark ({} symbols, {} matching threads): Processed {} orders in {} ms, {:.0f} events/s.",
+		numSymbols,
+		matchingThreads,
+		processed,
+		duration / 1000,
+		processed * 1e6 / std::max<std::int64_t>(duration, 1)
+	) << std::endl;
+}
@@ -0,0 +1,76 @@
+#include "../Include/PerfCounter.h"
+
+#if defined(__linux__)
+#include <cstring>
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+#if defined(__linux__)
+
+PerfCounter::PerfCounter(PerfEvent event)
+{
+	perf_event_attr attributes;
+	std::memset(&attributes, 0, sizeof(attributes));
+
+	attributes.size = sizeof(attributes);
+	attributes.type = PERF_TYPE_HARDWARE;
+	attributes.config = (event == PerfEvent::Branches)
+		? PERF_COUNT_HW_BRANCH_INSTRUCTIONS
+		: PERF_COUNT_HW_BRANCH_MISSES;
+	attributes.disabled = 1;
+	attributes.inherit = 1;
+	attributes.exclude_kernel = 1;
+	attributes.exclude_hv = 1;
+
+	// Calling thread on any CPU, a failure leaves the counter unavailable
+
+	fd_ = static_cast<int>(syscall(SYS_perf_event_open, &attributes, 0, -1, -1, 0));
+}
+
+PerfCounter::~PerfCounter()
+{
+	if (IsOpen()) close(fd_);
+}
+
+void PerfCounter::Start()
+{
+	if (!IsOpen()) return;
+
+	ioctl(fd_, PERF_EVENT_IOC_RESET, 0);
+	ioctl(fd_, PERF_EVENT_IOC_ENABLE, 0);
+}
+
+std::optional<std::uint64_t> PerfCounter::Stop()
+{
+	if (!IsOpen()) return std::nullopt;
+
+	ioctl(fd_, PERF_EVENT_IOC_DISABLE, 0);
+
+	std::uint64_t count = 0;
+	if (read(fd_, &count, sizeof(count)) != sizeof(count))
+		return std::nullopt;
+
+	return count;
+}
+
+#else
+
+PerfCounter::PerfCounter(PerfEvent)
+{
+}
+
+PerfCounter::~PerfCounter() = default;
+
+void PerfCounter::Start()
+{
+}
+
+std::optional<std::uint64_t> PerfCounter::Stop()
+{
+	return std::nullopt;
+}
+
+#endif
@@ -0,0 +1,209 @@
+#include "../Include/ProducerBenchmark.h"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <random>
+#include <thread>
+
+#include "../Include/OrderGenerator.h"
+
+namespace
+{
+	// Pregenerates a producer's events so that only the enqueue itself is timed
+
+	EventInformations GenerateProducerEvents(const BenchmarkParams& p, std::size_t producer, int numEvents)
+	{
+		const OrderId firstId = static_cast<OrderId>(producer * numEvents) + 1;
+
+		std::default_random_engine generator(static_cast<unsigned>(producer));
+		EventSampler sampler(p, firstId, firstId + static_cast<OrderId>(numEvents * 0.8));
+
+		EventInformations events;
+		events.reserve(numEvents);
+
+		for (int i = 0; i < numEvents; ++i)
+			events.push_back(sampler(generator));
+
+		return events;
+	}
+
+	std::int64_t Percentile99(std::vector<std::vector<std::int64_t>>& latencies, std::size_t& count)
+	{
+		std::vector<std::int64_t> merged;
+		for (const auto& producerLatencies : latencies)
+			merged.insert(merged.end(), producerLatencies.begin(), producerLatencies.end());
+
+		count = merged.size();
+		if (merged.empty()) return 0;
+
+		auto p99 = merged.begin() + static_cast<std::ptrdiff_t>(merged.size() * 0.99);
+		std::nth_element(merged.begin(), p99, merged.end());
+		return *p99;
+	}
+}
+
+void BenchmarkProducers(const BenchmarkParams& params, std::size_t numProducers, const OrderBookConfig& config)
+{
+	const int perProducer = params.numEvents_ / static_cast<int>(numProducers);
+
+	std::vector<EventInformations> events;
+	std::vector<std::vector<std::int64_t>> latencies(numProducers);
+	for (std::size_t producer = 0; producer < numProducers; ++producer)
+	{
+		events.push_back(GenerateProducerEvents(params, producer, perProducer));
+		latencies[producer].reserve(perProducer);
+	}
+
+	Journal::Remove("Debug/OrderBook.journal");
+	Journal journal{ "Debug/OrderBook.journal" };
+	OrderBookConfig journaledConfig = config;
+	journaledConfig.journal_ = &journal;
+
+	OrderBook orderbook{ journaledConfig };
+
+	// Release every producer at once so they contend on the queue
+
+	std::atomic<bool> go{ false };
+	std::vector<std::thread> producers;
+	for (std::size_t producer = 0; producer < numProducers; ++producer)
+	{
+		producers.emplace_back([&, producer]()
+		{
+			while (!go.load(std::memory_order_acquire)) {}
+
+			for (const auto& event : events[producer])
+			{
+				auto before = std::chrono::steady_clock::now();
+				SubmitEvent(orderbook, event);
+				auto after = std::chrono::steady_clock::now();
+				latencies[producer].push_back(std::chrono::duration_cast<std::chrono::nanoseconds>(after - before).count());
+			}
+		});
+	}
+
+	auto start = std::chrono::steady_clock::now();
+	go.store(true, std::memory_order_release);
+
+	for (auto& producer : producers)
+		producer.join();
+
+	// Include the time taken to drain the queue, not just to enqueue
+
+	orderbook.Size();
+
+	auto end = std::chrono::steady_clock::now();
+	auto duration = std::chrono::duration_cast<std::chrono::microseconds>(end - start).count();
+
+	std::size_t count;
+	const auto p99 = Percentile99(latencies, count);
+
+	std::cout << std::format
+	(
+		"[!] Producer Benchmark ({} producers, {}/{} queue): Processed {} orders in {} ms, {:.0f} events/s, p99 enqueue latency {} ns.",
+		numProducers,
+		QueueModeToString(config.queue_.mode_),
+		WaitStrategyToString(config.queue_.waitStrategy_),
+		count,
+		duration / 1000,
+		count * 1e6 / std::max<std::int64_t>(duration, 1),
+		p99
+	) << std::endl;
+}
+
+void BenchmarkAcknowledgements(const BenchmarkParams& params, std::size_t numProducers, std::size_t inFlight, const OrderBookConfig& config)
+{
+	const int perProducer = params.numEvents_ / static_cast<int>(numProducers);
+
+	std::vector<EventInformations> events;
+	std::vector<std::vector<std::int64_t>> latencies(numProducers);
+	for (std::size_t producer = 0; producer < numProducers; ++producer)
+	{
+		events.push_back(GenerateProducerEvents(params, producer, perProducer));
+		latencies[producer].reserve(perProducer);
+	}
+
+	Journal::Remove("Debug/OrderBook.journal");
+	Journal journal{ "Debug/OrderBook.journal" };
+	OrderBookConfig journaledConfig = config;
+	journaledConfig.journal_ = &journal;
+
+	OrderBook orderbook{ journaledConfig };
+
+	// A ring holds every request a producer keeps in flight, so the matcher never
+	// waits for room in it
+
+	std::vector<std::unique_ptr<CompletionRing>> rings;
+	std::vector<ProducerId> ids;
+	for (std::size_t producer = 0; producer < numProducers; ++producer)
+	{
+		rings.push_back(std::make_unique<CompletionRing>(inFlight));
+		ids.push_back(orderbook.AddProducer(*rings.back()));
+	}
+
+	std::atomic<bool> go{ false };
+	std::vector<std::thread> producers;
+	for (std::size_t producer = 0; producer < numProducers; ++producer)
+	{
+		producers.emplace_back([&, producer]()
+		{
+			// Completions of a producer arrive in the order it queued the requests,
+			// so the next one taken always matches the oldest submission time
+
+			std::vector<std::chrono::steady_clock::time_point> submitted(events[producer].size());
+			std::array<Completion, 64> taken;
+			std::size_t acknowledged = 0;
+
+			const auto take = [&](std::size_t count)
+			{
+				const auto now = std::chrono::steady_clock::now();
+				for (std::size_t i = 0; i < count; ++i, ++acknowledged)
+					latencies[producer].push_back(std::chrono::duration_cast<std::chrono::nanoseconds>(now - submitted[acknowledged]).count());
+			};
+
+			while (!go.load(std::memory_order_acquire)) {}
+
+			for (std::size_t next = 0; next < events[producer].size(); ++next)
+			{
+				while (next - acknowledged >= inFlight)
+					take(rings[producer]->Wait(taken));
+
+				submitted[next] = std::chrono::steady_clock::now();
+				SubmitEvent(orderbook, events[producer][next], ids[producer]);
+				take(rings[producer]->Poll(taken));
+			}
+
+			while (acknowledged < events[producer].size())
+				take(rings[producer]->Wait(taken));
+		});
+	}
+
+	auto start = std::chrono::steady_clock::now();
+	go.store(true, std::memory_order_release);
+
+	for (auto& producer : producers)
+		producer.join();
+
+	// Every request has been acknowledged by now, so the queue is drained
+
+	auto end = std::chrono::steady_clock::now();
+	auto duration = std::chrono::duration_cast<std::chrono::microseconds>(end - start).count();
+
+	std::size_t count;
+	const auto p99 = Percentile99(latencies, count);
+
+	std::cout << std::format
+	(
+		"[!] Acknowledgement Benchmark ({} producers, {} in flight, {}/{} queue): Processed {} orders in {} ms, {:.0f} events/s, p99 ack latency {} ns.",
+		numProducers,
+		inFlight,
+		QueueModeToString(config.queue_.mode_),
+		WaitStrategyToString(config.queue_.waitStrategy_),
+		count,
+		duration / 1000,
+		count * 1e6 / std::max<std::int64_t>(duration, 1),
+		p99
+	) << std::endl;
+}
@@ -0,0 +1,106 @@
+#include "../Include/RecoveryBenchmark.h"
+
+#include <chrono>
+#include <vector>
+
+namespace
+{
+	constexpr Price MidPrice = 1'000;
+	constexpr Price LevelsPerSide = 500;
+	constexpr std::size_t BatchSize = 4'096;
+
+	// Alternates bids below and asks above the mid price, so nothing ever matches
+
+	QueueEvent RestingOrder(OrderId id)
+	{
+		const bool isBuy = id % 2 == 0;
+		const Price offset = 1 + static_cast<Price>(id / 2 % LevelsPerSide);
+
+		return QueueEvent
+		{
+			AddOrderPayload
+			{
+				id,
+				OrderType::GoodTillCancel,
+				isBuy ? Side::Buy : Side::Sell,
+				isBuy ? MidPrice - offset : MidPrice + offset,
+				1 + static_cast<Quantity>(id % 100)
+			}
+		};
+	}
+
+	void SubmitRestingOrders(OrderBook& orderbook, OrderId firstId, OrderId lastId)
+	{
+		std::vector<QueueEvent> batch;
+		batch.reserve(BatchSize);
+
+		for (OrderId id = firstId; id <= lastId; ++id)
+		{
+			batch.push_back(RestingOrder(id));
+			if (batch.size() == BatchSize || id == lastId)
+			{
+				orderbook.SubmitBatch(batch);
+				batch.clear();
+			}
+		}
+
+		orderbook.Size();
+	}
+}
+
+void BenchmarkRecovery(std::size_t numOrders, std::size_t tailEvents)
+{
+	const auto journalPath = "Debug/Recovery.journal";
+	const auto snapshotPath = "Debug/Recovery.snapshot";
+
+	const OrderBookConfig config
+	{
+		.levelStorage_ = LevelStorage::Ladder,
+		.orderIdMapMode_ = OrderIdMapMode::Direct,
+		.maxOrderId_ = static_cast<OrderId>(numOrders + tailEvents),
+		.reservedOrders_ = numOrders + tailEvents
+	};
+
+	std::int64_t snapshotDuration = 0;
+
+	Journal::Remove(journalPath);
+
+	{
+		Journal journal{ journalPath };
+		OrderBookConfig journaledConfig = config;
+		journaledConfig.journal_ = &journal;
+
+		OrderBook orderbook{ journaledConfig };
+		SubmitRestingOrders(orderbook, 1, static_cast<OrderId>(numOrders));
+
+		auto start = std::chrono::steady_clock::now();
+		orderbook.TakeSnapshot(snapshotPath);
+		auto end = std::chrono::steady_clock::now();
+		snapshotDuration = std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count();
+
+		SubmitRestingOrders(orderbook, static_cast<OrderId>(numOrders) + 1, static_cast<OrderId>(numOrders + tailEvents));
+		journal.Flush();
+	}
+
+	// The restarted book carries on writing the journal it recovers from
+
+	Journal journal{ journalPath };
+	OrderBookConfig recoveredConfig = config;
+	recoveredConfig.journal_ = &journal;
+	OrderBook recovered{ recoveredConfig };
+
+	auto start = std::chrono::steady_clock::now();
+	recovered.Recover(snapshotPath, journalPath);
+	auto end = std::chrono::steady_clock::now();
+	auto recoveryDuration = std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count();
+
+	std::cout << std::format
+	(
+		"[!] Recovery Benchmark: Snapshot of {} resting orders taken in {} ms, recovered with a tail of {} journaled requests in {} ms ({} orders).",
+		numOrders,
+		snapshotDuration,
+		tailEvents,
+		recoveryDuration,
+		recovered.Size()
+	) << std::endl;
+}
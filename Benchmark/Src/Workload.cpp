@@ -0,0 +1,140 @@
+#include "../Include/Workload.h"
+
+#include <chrono>
+#include <cstring>
+#include <format>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+#include "../Include/OrderGenerator.h"
+
+namespace
+{
+	EventInformation ToEventInformation(const WorkloadRecord& record)
+	{
+		return { record.eventType_, record.orderId_, record.orderType_, record.side_, record.price_, record.quantity_ };
+	}
+
+	// Requests recorded up to now are due, all of them when replaying at full speed
+
+	auto DueFrom(std::chrono::steady_clock::time_point start, ReplayPace pace)
+	{
+		return [start, pace](const WorkloadRecord& record)
+			{
+				return pace == ReplayPace::MaxSpeed ||
+					std::chrono::nanoseconds{ record.timestamp_ } <= std::chrono::steady_clock::now() - start;
+			};
+	}
+}
+
+void RecordWorkload(const BenchmarkParams& p, const std::filesystem::path& path, double eventsPerSecond)
+{
+	const auto count = static_cast<std::size_t>(p.numEvents_);
+	MappedFile file{ path, sizeof(WorkloadHeader) + count * sizeof(WorkloadRecord) };
+
+	std::default_random_engine generator;
+	EventSampler sampler(p);
+	std::exponential_distribution<double> gapDist(eventsPerSecond / 1e9);
+
+	auto* records = reinterpret_cast<WorkloadRecord*>(file.Data() + sizeof(WorkloadHeader));
+	double timestamp = 0.0;
+
+	for (std::size_t i = 0; i < count; ++i)
+	{
+		const EventInformation event = sampler(generator);
+		records[i] = WorkloadRecord
+		{
+			.timestamp_ = static_cast<std::uint64_t>(timestamp),
+			.orderId_ = event.orderId_,
+			.price_ = event.price_,
+			.quantity_ = event.quantity_,
+			.eventType_ = event.eventType_,
+			.orderType_ = event.orderType_,
+			.side_ = event.side_
+		};
+
+		timestamp += gapDist(generator);
+	}
+
+	// Written last, so that a partly written file is never taken for a workload
+
+	const WorkloadHeader header{ .recordCount_ = count };
+	std::memcpy(file.Data(), &header, sizeof(header));
+	file.Flush();
+}
+
+Workload::Workload(const std::filesystem::path& path)
+	: file_{ path }
+{
+	if (file_.Size() < sizeof(WorkloadHeader))
+		throw std::runtime_error(std::format("Workload {} is truncated.", path.string()));
+
+	const auto& header = *reinterpret_cast<const WorkloadHeader*>(file_.Data());
+
+	if (header.magic_ != WorkloadHeader::Magic ||
+		header.version_ != WorkloadHeader::CurrentVersion ||
+		header.recordSize_ != sizeof(WorkloadRecord))
+		throw std::runtime_error(std::format("{} is not a version {} workload.",
+			path.string(), WorkloadHeader::CurrentVersion));
+
+	if (sizeof(WorkloadHeader) + header.recordCount_ * sizeof(WorkloadRecord) > file_.Size())
+		throw std::runtime_error(std::format("Workload {} is truncated.", path.string()));
+}
+
+std::span<const WorkloadRecord> Workload::Records() const
+{
+	const auto* data = file_.Data();
+	const auto& header = *reinterpret_cast<const WorkloadHeader*>(data);
+
+	return { reinterpret_cast<const WorkloadRecord*>(data + sizeof(WorkloadHeader)),
+		static_cast<std::size_t>(header.recordCount_) };
+}
+
+void ReplayWorkload(const Workload& workload, OrderBook& book, ReplayPace pace, std::size_t batchSize)
+{
+	const auto records = workload.Records();
+	const auto due = DueFrom(std::chrono::steady_clock::now(), pace);
+
+	std::vector<QueueEvent> batch;
+	batch.reserve(batchSize);
+
+	for (std::size_t next = 0; next < records.size(); )
+	{
+		while (!due(records[next]))
+			CpuRelax();
+
+		if (batchSize <= 1)
+		{
+			SubmitEvent(book, ToEventInformation(records[next++]));
+			continue;
+		}
+
+		// Flush a full batch, or whatever was due when the replay caught up
+
+		batch.clear();
+		while (next < records.size() && batch.size() < batchSize && due(records[next]))
+			batch.push_back(ToQueueEvent(ToEventInformation(records[next++])));
+
+		book.SubmitBatch(batch);
+	}
+}
+
+void ReplayWorkload(const Workload& workload, InlineOrderBook& book, ReplayPace pace)
+{
+	const auto due = DueFrom(std::chrono::steady_clock::now(), pace);
+
+	for (const auto& record : workload.Records())
+	{
+		while (!due(record))
+			CpuRelax();
+
+		switch (record.eventType_)
+		{
+		case EventType::AddOrder: book.AddOrder(record.orderId_, record.orderType_, record.side_, record.price_, record.quantity_); break;
+		case EventType::ModifyOrder: book.ModifyOrder(record.orderId_, record.side_, record.price_, record.quantity_); break;
+		case EventType::CancelOrder: book.CancelOrder(record.orderId_); break;
+		default: throw std::logic_error("Unsupported event.");
+		}
+	}
+}
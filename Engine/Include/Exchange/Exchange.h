@@ -0,0 +1,69 @@
+#pragma once
+
+#include <memory>
+#include <span>
+#include <vector>
+
+#include "ExchangeConfig.h"
+#include "../Orderbook/OrderBook.h"
+#include "../Queue/QueueManager.h"
+
+// Owns the books of many symbols and shards them across a fixed set of matching
+// threads. Each thread drains one queue and routes its events to the book of their
+// symbol, so books on different threads never contend with each other
+
+class Exchange
+{
+public:
+
+	explicit Exchange(const ExchangeConfig& config = {});
+	~Exchange();
+
+	Exchange(const Exchange&) = delete;
+	Exchange(Exchange&&) = delete;
+	Exchange& operator=(const Exchange&) = delete;
+	Exchange& operator=(Exchange&&) = delete;
+
+	// Creates the book for a symbol on the matching thread with the fewest symbols.
+	// Symbols must be added before any events are submitted
+	OrderBook& AddSymbol(SymbolId symbol);
+
+	// APIs to queue order requests on the matching thread owning the symbol
+	void AddOrderToQueue(SymbolId symbol, OrderId id, OrderType type, Side side, Price price, Quantity quantity);
+	void ModifyOrderToQueue(SymbolId symbol, OrderId id, Side side, Price price, Quantity quantity);
+	void CancelOrderToQueue(SymbolId symbol, OrderId id);
+
+	// Routes events by the symbol id in their payload, consecutive events bound for
+	// the same matching thread are enqueued together
+	void SubmitEvent(const QueueEvent& event);
+	void SubmitBatch(std::span<const QueueEvent> events);
+
+	// Blocks until every event submitted before the call has been processed
+	void WaitForAllEvents() const;
+
+	OrderBook& GetBook(SymbolId symbol) const;
+	std::size_t SymbolCount() const;
+	std::size_t MatchingThreadCount() const;
+
+private:
+
+	ExchangeConfig config_;
+
+	// Books indexed by symbol id, null for ids without a book
+	std::vector<std::unique_ptr<OrderBook>> books_;
+
+	// Matching thread of each symbol, and the number of symbols on each thread
+	std::vector<std::size_t> shardOf_;
+	std::vector<std::size_t> shardSymbols_;
+	std::size_t symbolCount_{ 0 };
+
+	// One queue and worker thread per matching thread. Declared last so the workers
+	// stop before the books they feed are destroyed
+	std::vector<std::unique_ptr<QueueManager>> shards_;
+
+	// Returns the matching thread of a symbol, throws if the symbol has no book
+	std::size_t ShardOf(SymbolId symbol) const;
+
+	// Handler of every matching thread, hands each run of same-symbol events to its book
+	void HandleShardEvents(std::span<const QueueEvent> events);
+};
@@ -0,0 +1,22 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+#include "../Orderbook/OrderBookConfig.h"
+
+// Construction-time options for the Exchange
+
+struct ExchangeConfig
+{
+	// Number of matching threads the symbols are sharded across
+	std::size_t matchingThreads_{ 1 };
+
+	// Cores the matching threads are pinned to, in order. Threads past the end of
+	// the list are left to the scheduler
+	std::vector<int> cores_{ };
+
+	// Options for every book, and the queue of each matching thread. The symbol id
+	// and pinned core are filled in per book and per thread
+	OrderBookConfig book_{ };
+};
@@ -0,0 +1,105 @@
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+
+#include "JournalRecord.h"
+#include "../Queue/DrainedRing.h"
+#include "../Util/MappedFile.h"
+
+// Header at the start of every journal segment, followed by up to capacity_ records
+
+struct JournalSegmentHeader
+{
+	static constexpr std::uint64_t Magic = 0x4C4E524A'4B4F4F42; // "BOOKJRNL"
+	static constexpr std::uint32_t CurrentVersion = 1;
+
+	std::uint64_t magic_{ Magic };
+	std::uint32_t version_{ CurrentVersion };
+	std::uint32_t recordSize_{ sizeof(JournalRecord) };
+	std::uint64_t capacity_{ };
+
+	// Records written so far, updated after each batch so that a segment is always
+	// readable up to the last complete record
+	std::uint64_t recordCount_{ };
+
+	std::uint8_t reserved_[32]{ };
+};
+
+static_assert(sizeof(JournalSegmentHeader) == 64);
+
+// Binary audit log of book events. Books append fixed-size records, which are never
+// formatted until decoded, and a writer thread (see DrainedRing) copies them into
+// memory-mapped segment files named <path>.000000, <path>.000001, ... each
+// preallocated to a fixed number of records.
+//
+// A journal opened at the path of an earlier one carries on after its segments, so an
+// engine restarts by opening its journal, building its books on it and recovering each
+// of them from its latest snapshot and that same journal path (see OrderBook::Recover).
+// Requests are numbered on from the recovered ones, so a later recovery replays the
+// records of both runs in order. An engine starting afresh removes the journal first
+
+class Journal
+{
+public:
+
+	explicit Journal(std::filesystem::path path, std::size_t segmentRecords = 1 << 20, std::size_t capacity = 1 << 16);
+
+	// Writes any records still in the ring before returning
+	~Journal();
+
+	Journal(const Journal&) = delete;
+	Journal(Journal&&) = delete;
+	Journal& operator=(const Journal&) = delete;
+	Journal& operator=(Journal&&) = delete;
+
+	// Matching thread side, spins while the writer makes room in a full ring
+
+	void Append(const JournalRecord& record) { ring_.Push(record); }
+
+	// Blocks until every record appended before the call is in a segment file
+	void Flush() const { ring_.Flush(); }
+
+	// Path of a given segment of the journal at path
+	static std::filesystem::path SegmentPath(const std::filesystem::path& path, std::size_t segment);
+
+	// Deletes every segment of the journal at path, which must not be open
+	static void Remove(const std::filesystem::path& path);
+
+private:
+
+	// Consumer copying records from the ring into the segment being written
+	struct SegmentWriter
+	{
+		Journal* journal_;
+		std::size_t operator()(MpscRing<JournalRecord>& ring) { return journal_->WriteRecords(ring); }
+	};
+
+	std::filesystem::path path_;
+	std::size_t segmentRecords_;
+
+	// Segment being written, only touched by the writer thread once it has started
+	std::size_t segmentIndex_;
+	MappedFile segment_;
+
+	// Drained by the writer thread, constructed last so that it only starts once the
+	// first segment is open
+	DrainedRing<JournalRecord, SegmentWriter> ring_;
+
+	JournalSegmentHeader& Header();
+	JournalRecord* Records();
+
+	// Number of segments of the journal at path, the first new segment takes the next index
+	static std::size_t SegmentCount(const std::filesystem::path& path);
+
+	// Creates and maps the first segment, after those of an earlier journal
+	MappedFile CreateFirstSegment();
+
+	// Creates and maps a segment, stamping its header
+	MappedFile MapSegment(std::size_t index);
+	void OpenSegment(std::size_t index);
+
+	// Copies the next records waiting in the ring into the segment, rolling over to a
+	// new segment once it is full. Returns the number copied
+	std::size_t WriteRecords(MpscRing<JournalRecord>& ring);
+};
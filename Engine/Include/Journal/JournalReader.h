@@ -0,0 +1,37 @@
+#pragma once
+
+#include <filesystem>
+#include <span>
+#include <vector>
+
+#include "Journal.h"
+
+// Maps every segment of a journal read-only, in order, for offline decoding and
+// recovery. Throws runtime_error if a segment is not a journal of this version
+
+class JournalReader
+{
+public:
+
+	explicit JournalReader(const std::filesystem::path& path);
+
+	std::size_t SegmentCount() const;
+
+	// Records written to a segment, in the order they were appended
+	std::span<const JournalRecord> GetSegment(std::size_t segment) const;
+
+	// Total number of records across all segments
+	std::size_t Size() const;
+
+	template <typename Visitor>
+	void ForEachRecord(Visitor&& visitor) const
+	{
+		for (std::size_t segment = 0; segment < SegmentCount(); ++segment)
+			for (const auto& record : GetSegment(segment))
+				visitor(record);
+	}
+
+private:
+
+	std::vector<MappedFile> segments_;
+};
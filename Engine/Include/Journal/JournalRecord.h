@@ -0,0 +1,96 @@
+#pragma once
+
+#include <cstdint>
+#include <format>
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+#include "../Orderbook/Using.h"
+#include "../Enum/OrderType.h"
+#include "../Enum/Side.h"
+
+enum class JournalEvent : std::uint8_t
+{
+	BookInitialized,
+	BookDestroyed,
+	OrderAdded,
+	DuplicateAddRejected,
+	FillAndKillRejected,
+	FillOrKillRejected,
+	ModifyRejected,
+	ModifyAccepted,
+	CancelRejected,
+	OrderCancelled,
+	OrderReduced,
+	OrderIdRejected,
+};
+
+// Audit record of a single book event, written by the OrderBook to its Journal in
+// place of a formatted log line. Orders are described as they stood when the event
+// was recorded, fields which do not apply to an event are left zeroed
+
+struct JournalRecord
+{
+	// Nanoseconds since the epoch of the system clock
+	std::int64_t timestamp_{ };
+
+	// Arrival sequence number of the request being handled, 0 outside of a request
+	std::uint64_t sequence_{ };
+
+	OrderId orderId_{ };
+	SymbolId symbolId_{ };
+	Price price_{ };
+	Quantity quantity_{ };
+	JournalEvent event_{ };
+	OrderType orderType_{ };
+	Side side_{ };
+};
+
+static_assert(std::is_trivially_copyable_v<JournalRecord>);
+static_assert(sizeof(JournalRecord) == 40);
+
+// Renders the message of a record exactly as the book logs it as text
+
+inline std::string FormatJournalMessage(const JournalRecord& record)
+{
+	auto orderInfo = [&record]()
+		{
+			return std::format("ID: {}, Type: {}, Side: {}, Price: {}, Quantity: {}",
+				record.orderId_,
+				OrderTypeToString(record.orderType_),
+				SideToString(record.side_),
+				record.price_,
+				record.quantity_);
+		};
+
+	switch (record.event_)
+	{
+	case JournalEvent::BookInitialized:
+		return "Orderbook initialized.";
+	case JournalEvent::BookDestroyed:
+		return "Orderbook destroyed.";
+	case JournalEvent::OrderAdded:
+		return std::format("{}: Order added successfully. Info: {{ {} }}", record.orderId_, orderInfo());
+	case JournalEvent::DuplicateAddRejected:
+		return std::format("{}: Add order request denied. The order already exists.", record.orderId_);
+	case JournalEvent::FillAndKillRejected:
+		return std::format("{}: Add order request denied. Fill and kill order cannot be matched.", record.orderId_);
+	case JournalEvent::FillOrKillRejected:
+		return std::format("{}: Add order request denied. Fill or kill order cannot be filled.", record.orderId_);
+	case JournalEvent::ModifyRejected:
+		return std::format("{}: Modify order request denied. Order does not exist.", record.orderId_);
+	case JournalEvent::ModifyAccepted:
+		return std::format("{}: Request to modify order accepted.", record.orderId_);
+	case JournalEvent::CancelRejected:
+		return std::format("{}: Request to cancel order denied. Order does not exist.", record.orderId_);
+	case JournalEvent::OrderCancelled:
+		return std::format("{}: Order cancelled successfully. Info: {{ {} }}", record.orderId_, orderInfo());
+	case JournalEvent::OrderReduced:
+		return std::format("{}: Order reduced in place. Info: {{ {} }}", record.orderId_, orderInfo());
+	case JournalEvent::OrderIdRejected:
+		return std::format("{}: Add order request denied. Order id is out of range.", record.orderId_);
+	default:
+		return std::format("{}: Unknown journal event {}.", record.orderId_, static_cast<int>(record.event_));
+	}
+}
@@ -0,0 +1,53 @@
+#pragma once
+
+#include <cstdint>
+#include <type_traits>
+#include <vector>
+
+#include "../Orderbook/Using.h"
+#include "../Enum/Side.h"
+
+// Change to one price level of a book, published by the OrderBook to its
+// MarketDataFeed whenever the aggregate quantity or order count of a level changes
+
+struct LevelDelta
+{
+	// Position of the delta in the book's stream, consecutive without gaps
+	std::uint64_t sequence_{ };
+
+	SymbolId symbolId_{ };
+	Price price_{ };
+
+	// Aggregate quantity and order count of the level after the change, a count of
+	// zero means the level has been removed
+	Quantity quantity_{ };
+	std::uint32_t count_{ };
+
+	Side side_{ };
+};
+
+static_assert(std::is_trivially_copyable_v<LevelDelta>);
+static_assert(sizeof(LevelDelta) == 32);
+
+struct DepthLevel
+{
+	Price price_{ };
+	Quantity quantity_{ };
+	std::uint32_t count_{ };
+};
+
+using DepthLevels = std::vector<DepthLevel>;
+
+// Best levels of each side of a book, consistent with the delta stream up to and
+// including the delta numbered sequence_. A subscriber syncs by applying only the
+// deltas numbered after it
+
+struct DepthSnapshot
+{
+	std::uint64_t sequence_{ };
+	SymbolId symbolId_{ };
+
+	// From the best price to the worst
+	DepthLevels bids_;
+	DepthLevels asks_;
+};
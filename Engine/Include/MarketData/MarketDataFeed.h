@@ -0,0 +1,37 @@
+#pragma once
+
+#include <span>
+
+#include "LevelDelta.h"
+#include "../Queue/DrainedRing.h"
+
+// L2 level deltas published by the books, handed to the delta handler in batches and
+// in publication order (see DrainedRing)
+
+class MarketDataFeed
+{
+public:
+
+	using DeltaHandler = BatchHandler<LevelDelta>::Handler;
+
+	explicit MarketDataFeed(DeltaHandler deltaHandler, std::size_t capacity = 1 << 16);
+
+	// Hands any deltas still in the ring to the handler before returning
+	~MarketDataFeed() = default;
+
+	MarketDataFeed(const MarketDataFeed&) = delete;
+	MarketDataFeed(MarketDataFeed&&) = delete;
+	MarketDataFeed& operator=(const MarketDataFeed&) = delete;
+	MarketDataFeed& operator=(MarketDataFeed&&) = delete;
+
+	// Matching thread side, spins while the consumer makes room in a full ring
+	void Publish(const LevelDelta& delta) { ring_.Push(delta); }
+
+	// Blocks until every delta published before the call has been handled
+	void Flush() const { ring_.Flush(); }
+
+private:
+
+	// Drained by a consumer thread handing batches to the handler
+	DrainedRing<LevelDelta, BatchHandler<LevelDelta>> ring_;
+};
@@ -0,0 +1,37 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+#include "LevelDelta.h"
+
+// Number of levels of each side kept in the TopOfBook
+inline constexpr std::size_t TopOfBookLevels = 10;
+
+// Fixed-size view of the best levels of a book, published by the matching thread
+// after every request that changes them. Only the first bidLevels_ and askLevels_
+// entries of each side are valid, best first
+
+struct TopOfBook
+{
+	// Arrival sequence number of the last request that changed the view
+	std::uint64_t sequence_{ };
+
+	// Number of resting orders in the book
+	std::uint64_t orders_{ };
+
+	std::uint32_t bidLevels_{ };
+	std::uint32_t askLevels_{ };
+
+	std::array<DepthLevel, TopOfBookLevels> bids_{ };
+	std::array<DepthLevel, TopOfBookLevels> asks_{ };
+
+	bool HasBid() const { return bidLevels_ > 0; }
+	bool HasAsk() const { return askLevels_ > 0; }
+	const DepthLevel& BestBid() const { return bids_[0]; }
+	const DepthLevel& BestAsk() const { return asks_[0]; }
+};
+
+static_assert(std::is_trivially_copyable_v<TopOfBook>);
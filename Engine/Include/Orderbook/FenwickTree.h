@@ -0,0 +1,45 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+// Fixed-size array of quantities supporting point updates and prefix sums in
+// O(log n), i.e. twelve steps for 4096 entries. Entry i of the tree holds the sum
+// of the values in (i - lowbit(i), i], using one-based indices internally
+
+class FenwickTree
+{
+public:
+
+	explicit FenwickTree(std::size_t size)
+		: tree_(size + 1, 0)
+	{
+	}
+
+	std::size_t Size() const { return tree_.size() - 1; }
+
+	// Adds delta to the value at index, the value must not become negative
+
+	void Add(std::size_t index, std::int64_t delta)
+	{
+		for (++index; index < tree_.size(); index += index & (~index + 1))
+			tree_[index] += delta;
+	}
+
+	// Sum of the first count values
+
+	std::int64_t PrefixSum(std::size_t count) const
+	{
+		std::int64_t sum = 0;
+		for (; count > 0; count &= count - 1)
+			sum += tree_[count];
+
+		return sum;
+	}
+
+	std::int64_t Total() const { return PrefixSum(Size()); }
+
+private:
+
+	std::vector<std::int64_t> tree_;
+};
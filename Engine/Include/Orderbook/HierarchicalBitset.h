@@ -0,0 +1,149 @@
+#pragma once
+
+#include <bit>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+// Fixed-size bitset with a summary word for every 64 words below it, up to a
+// single root word. Finding the first, last, next or previous set bit touches
+// one word per level, i.e. two words for up to 4096 bits
+
+class HierarchicalBitset
+{
+public:
+
+	static constexpr std::size_t npos = std::numeric_limits<std::size_t>::max();
+
+	explicit HierarchicalBitset(std::size_t size)
+		: size_{ size }
+	{
+		std::size_t words = (size + 63) / 64;
+		do
+		{
+			levels_.emplace_back(words, 0);
+			words = (words + 63) / 64;
+		} while (levels_.back().size() > 1);
+	}
+
+	std::size_t Size() const { return size_; }
+	bool None() const { return levels_.back()[0] == 0; }
+
+	bool Test(std::size_t index) const
+	{
+		return (levels_[0][index / 64] >> (index % 64)) & 1;
+	}
+
+	void Set(std::size_t index)
+	{
+		// Stop once a word was already non-zero, its parents are already set
+
+		for (auto& level : levels_)
+		{
+			auto& word = level[index / 64];
+			const bool wasEmpty = word == 0;
+			word |= std::uint64_t{ 1 } << (index % 64);
+			if (!wasEmpty) return;
+			index /= 64;
+		}
+	}
+
+	void Reset(std::size_t index)
+	{
+		// Stop once a word is still non-zero, its parents must stay set
+
+		for (auto& level : levels_)
+		{
+			auto& word = level[index / 64];
+			word &= ~(std::uint64_t{ 1 } << (index % 64));
+			if (word != 0) return;
+			index /= 64;
+		}
+	}
+
+	std::size_t FindFirst() const
+	{
+		if (None()) return npos;
+		return DescendFirst(levels_.size() - 1, 0);
+	}
+
+	std::size_t FindLast() const
+	{
+		if (None()) return npos;
+		return DescendLast(levels_.size() - 1, 0);
+	}
+
+	// First set bit strictly after index
+
+	std::size_t FindNext(std::size_t index) const
+	{
+		std::size_t position = index + 1;
+		for (std::size_t level = 0; level < levels_.size(); ++level)
+		{
+			const std::size_t word = position / 64;
+			if (word >= levels_[level].size()) return npos;
+
+			const std::uint64_t bits = levels_[level][word] & (~std::uint64_t{ 0 } << (position % 64));
+			if (bits != 0)
+			{
+				const std::size_t found = word * 64 + std::countr_zero(bits);
+				return level == 0 ? found : DescendFirst(level - 1, found);
+			}
+
+			position = word + 1;
+		}
+		return npos;
+	}
+
+	// Last set bit strictly before index
+
+	std::size_t FindPrev(std::size_t index) const
+	{
+		if (index == 0) return npos;
+
+		std::size_t position = index - 1;
+		for (std::size_t level = 0; level < levels_.size(); ++level)
+		{
+			const std::size_t word = position / 64;
+			const std::uint64_t bits = levels_[level][word] & (~std::uint64_t{ 0 } >> (63 - position % 64));
+			if (bits != 0)
+			{
+				const std::size_t found = word * 64 + 63 - std::countl_zero(bits);
+				return level == 0 ? found : DescendLast(level - 1, found);
+			}
+
+			if (word == 0) return npos;
+			position = word - 1;
+		}
+		return npos;
+	}
+
+private:
+
+	// Follows the lowest (or highest) set bits down from a non-zero word to level 0
+
+	std::size_t DescendFirst(std::size_t level, std::size_t word) const
+	{
+		while (true)
+		{
+			const std::size_t found = word * 64 + std::countr_zero(levels_[level][word]);
+			if (level-- == 0) return found;
+			word = found;
+		}
+	}
+
+	std::size_t DescendLast(std::size_t level, std::size_t word) const
+	{
+		while (true)
+		{
+			const std::size_t found = word * 64 + 63 - std::countl_zero(levels_[level][word]);
+			if (level-- == 0) return found;
+			word = found;
+		}
+	}
+
+	std::size_t size_;
+
+	// levels_[0] holds one bit per index, each level above holds one bit per word below
+	std::vector<std::vector<std::uint64_t>> levels_;
+};
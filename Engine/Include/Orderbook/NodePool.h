@@ -0,0 +1,137 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <vector>
+
+// Slab allocator for the nodes of a node-based container, such as the std::map
+// holding price levels. Nodes are carved out of fixed-size slabs like orders in
+// OrderPool and recycled through an intrusive free list, so levels which empty and
+// refill reuse their node rather than going back to the heap. Each node size gets
+// slabs and a free list of its own, as containers may allocate other blocks besides
+// their nodes (e.g. the container proxy of checked iterators in MSVC debug builds)
+
+class NodePool
+{
+public:
+
+	explicit NodePool(std::size_t slabSize = 256)
+		: slabSize_{ slabSize }
+	{
+	}
+
+	NodePool(const NodePool&) = delete;
+	NodePool(NodePool&&) = delete;
+	NodePool& operator=(const NodePool&) = delete;
+	NodePool& operator=(NodePool&&) = delete;
+
+	void* Allocate(std::size_t size, std::size_t alignment)
+	{
+		if (alignment > alignof(Slot)) return ::operator new(size, std::align_val_t{ alignment });
+
+		const auto slots = SlotsFor(size);
+		if (slots >= freeLists_.size()) freeLists_.resize(slots + 1, nullptr);
+
+		auto*& free = freeLists_[slots];
+		if (!free) AddSlab(slots);
+
+		auto* node = free;
+		free = node->next_;
+		--available_;
+		return node;
+	}
+
+	void Deallocate(void* node, std::size_t size, std::size_t alignment)
+	{
+		if (alignment > alignof(Slot))
+		{
+			::operator delete(node, std::align_val_t{ alignment });
+			return;
+		}
+
+		auto*& free = freeLists_[SlotsFor(size)];
+		free = ::new (node) FreeNode{ free };
+		++available_;
+	}
+
+	// Nodes carved out of the slabs so far, and those handed out, of any size
+	std::size_t Capacity() const { return capacity_; }
+	std::size_t InUse() const { return capacity_ - available_; }
+
+private:
+
+	struct FreeNode
+	{
+		FreeNode* next_;
+	};
+
+	using Slot = std::max_align_t;
+
+	static std::size_t SlotsFor(std::size_t size)
+	{
+		const auto bytes = size < sizeof(FreeNode) ? sizeof(FreeNode) : size;
+		return (bytes + sizeof(Slot) - 1) / sizeof(Slot);
+	}
+
+	void AddSlab(std::size_t slotsPerNode)
+	{
+		auto& slab = slabs_.emplace_back(std::make_unique<Slot[]>(slabSize_ * slotsPerNode));
+		auto*& free = freeLists_[slotsPerNode];
+
+		for (std::size_t i = slabSize_; i-- > 0;)
+			free = ::new (&slab[i * slotsPerNode]) FreeNode{ free };
+
+		capacity_ += slabSize_;
+		available_ += slabSize_;
+	}
+
+	std::size_t slabSize_;
+	std::size_t capacity_{ 0 };
+	std::size_t available_{ 0 };
+	std::vector<std::unique_ptr<Slot[]>> slabs_;
+
+	// Free nodes indexed by their size in slots
+	std::vector<FreeNode*> freeLists_;
+};
+
+// Standard allocator drawing from a NodePool, for containers which allocate one
+// node at a time. Rebound copies share the pool, which must outlive the container
+
+template <typename T>
+class NodeAllocator
+{
+public:
+
+	using value_type = T;
+
+	explicit NodeAllocator(NodePool& pool) noexcept
+		: pool_{ &pool }
+	{
+	}
+
+	template <typename U>
+	NodeAllocator(const NodeAllocator<U>& other) noexcept
+		: pool_{ other.pool_ }
+	{
+	}
+
+	T* allocate(std::size_t count)
+	{
+		return static_cast<T*>(pool_->Allocate(count * sizeof(T), alignof(T)));
+	}
+
+	void deallocate(T* node, std::size_t count) noexcept
+	{
+		pool_->Deallocate(node, count * sizeof(T), alignof(T));
+	}
+
+	template <typename U>
+	bool operator==(const NodeAllocator<U>& other) const noexcept { return pool_ == other.pool_; }
+
+private:
+
+	template <typename U> friend class NodeAllocator;
+
+	NodePool* pool_;
+};
@@ -1,6 +1,5 @@
 #pragma once
 
-#include <list>
 #include <format>
 
 #include "Using.h"
@@ -31,6 +30,22 @@ public:
 	void Fill(Quantity quantity) { remainingQuantity_ -= quantity; }
 	void SetMarketPrice(Price price) { price_ = price; }
 
+	// Cancels part of the open quantity, keeping the quantity filled so far
+	void Reduce(Quantity quantity)
+	{
+		initialQuantity_ -= quantity;
+		remainingQuantity_ -= quantity;
+	}
+
+	// Replaces the side, price and quantity of an order moving to a new level
+	void Amend(Side side, Price price, Quantity quantity)
+	{
+		side_ = side;
+		price_ = price;
+		initialQuantity_ = quantity;
+		remainingQuantity_ = quantity;
+	}
+
 	std::string ToString() const {
 		return std::format("ID: {}, Type: {}, Side: {}, Price: {}, Quantity: {}",
 			GetOrderId(),
@@ -47,7 +62,12 @@ private:
 	Price price_;
 	Quantity initialQuantity_;
 	Quantity remainingQuantity_;
+
+	// Intrusive links to the neighbouring orders at the same price level
+	friend class OrderList;
+	Order* prev_{ nullptr };
+	Order* next_{ nullptr };
 };
 
-using OrderPointer = std::shared_ptr<Order>;
-using OrderPointers = std::list<OrderPointer>;
+// Orders are owned by the OrderPool, pointers are non-owning handles
+using OrderPointer = Order*;
@@ -1,10 +1,11 @@
 #pragma once
 
+#include <chrono>
 #include <map>
-#include <unordered_map>
 #include <thread>
 #include <mutex>
 #include <condition_variable>
+#include <filesystem>
 #include <iostream>
 #include <format>
 #include <string>
@@ -12,47 +13,110 @@
 #include <optional>
 #include <numeric>
 #include <variant>
+#include <span>
 
 #include "Using.h"
 #include "Order.h"
+#include "OrderList.h"
+#include "OrderPool.h"
+#include "OrderIdMap.h"
 #include "OrderModify.h"
 #include "Trade.h"
+#include "OrderResult.h"
+#include "ThreadingPolicy.h"
 #include "OrderbookLevelInfos.h"
+#include "OrderBookConfig.h"
+#include "PriceLevels.h"
 #include "../Enum/OrderEvent.h"
 #include "../Queue/QueueManager.h"
+#include "../Report/ExecutionReportSink.h"
+#include "../Report/CompletionRing.h"
+#include "../Journal/Journal.h"
+#include "../MarketData/MarketDataFeed.h"
+#include "../MarketData/TopOfBook.h"
+#include "../Util/Seqlock.h"
+#include "../Util/LatencyTrace.h"
 #include "../Log/FileLogger.h"
 
-class OrderBook
+// The threading policy (see ThreadingPolicy.h) decides how requests reach the book:
+// queued books take them from any thread and match them on a worker thread, inline
+// books match them on the caller's thread and return their outcome
+
+template <typename Threading>
+class BasicOrderBook
 {
 public:
 
-	OrderBook()
-		: queueManager_([this](const QueueEvent& event) { HandleEvent(event); })
-	{ 
-		FileLogger::Init("Debug/OrderBook.Log");
-		FileLogger::Get()->info("Orderbook initialized.");
-	}
+	// Builds a book that processes its events on a worker thread of its own, or on
+	// the calling thread when inline
+	explicit BasicOrderBook(const OrderBookConfig& config = {});
 
-	~OrderBook()
-	{
-		FileLogger::Get()->info("Orderbook destroyed.");
-		FileLogger::Cleanup();
-	}
+	// Builds a book fed by a queue shared with other books, whose handler routes
+	// events carrying config.symbolId_ to this book's HandleEvents (see Exchange)
+	BasicOrderBook(const OrderBookConfig& config, QueueManager& sharedQueue) requires (Threading::Queued);
+
+	~BasicOrderBook();
+
+	BasicOrderBook(const BasicOrderBook&) = delete;
+	BasicOrderBook(BasicOrderBook&&) = delete;
+	BasicOrderBook& operator=(const BasicOrderBook&) = delete;
+	BasicOrderBook& operator=(BasicOrderBook&&) = delete;
 
-	OrderBook(const OrderBook&) = delete;
-	OrderBook(OrderBook&&) = delete;
-	OrderBook& operator=(const OrderBook&) = delete;
-	OrderBook& operator=(OrderBook&&) = delete;
+	// APIs to queue order requests, returning the ticket their completion will carry
+	// if they are queued for a producer
+	Ticket AddOrderToQueue(OrderId id, OrderType type, Side side, Price price, Quantity quantity, ProducerId producer = 0) requires (Threading::Queued);
+	Ticket ModifyOrderToQueue(OrderId id, Side side, Price price, Quantity quantity, ProducerId producer = 0) requires (Threading::Queued);
+	Ticket CancelOrderToQueue(OrderId id, ProducerId producer = 0) requires (Threading::Queued);
 
-	// APIs to queue order requests
-	void AddOrderToQueue(OrderId id, OrderType type, Side side, Price price, Quantity quantity);
-	void ModifyOrderToQueue(OrderId id, Side side, Price price, Quantity quantity);
-	void CancelOrderToQueue(OrderId id);
+	// Queues a burst of order requests in order, synchronizing on the queue once
+	// rather than once per request. Returns the ticket of the last one
+	Ticket SubmitBatch(std::span<const QueueEvent> events) requires (Threading::Queued);
+
+	// Registers the completion ring of a producer and returns the id to queue its
+	// requests under. The outcome of each of them is then pushed to the ring once
+	// handled, requests queued under no producer are not acknowledged. A book takes
+	// up to 255 producers
+	ProducerId AddProducer(CompletionRing& completions) requires (Threading::Queued);
+
+	// APIs to handle order requests inline, returning their outcome. The result is
+	// reused by the next request to the book
+	const OrderResult& AddOrder(OrderId id, OrderType type, Side side, Price price, Quantity quantity) requires (!Threading::Queued);
+	const OrderResult& ModifyOrder(OrderId id, Side side, Price price, Quantity quantity) requires (!Threading::Queued);
+	const OrderResult& CancelOrder(OrderId id) requires (!Threading::Queued);
 
 	// Thread-safe API to parse events, extract order information payload and call
 	// private APIs to process in the orderbook - invoked by the QueueManager's worked thread
 	void HandleEvent(const QueueEvent& event);
 
+	// Processes a batch of events under a single acquisition of the orderbook lock
+	void HandleEvents(std::span<const QueueEvent> events);
+
+	// Writes a point-in-time copy of the resting orders to path. The matcher is only
+	// held up while the book is copied into memory, the file is written afterwards.
+	// Returns the arrival sequence number of the last request reflected in it
+	std::uint64_t TakeSnapshot(const std::filesystem::path& path) const;
+
+	// Rebuilds an empty book from a snapshot of the same symbol, then replays the
+	// requests the journal at journalPath (if any) recorded after the snapshot. Call
+	// before queuing any requests, the replay is neither journaled nor reported.
+	// Requests made afterwards are numbered on from the last one recovered, and the
+	// journal may be the one the book goes on writing to (see Journal)
+	void Recover(const std::filesystem::path& snapshotPath, const std::filesystem::path& journalPath = { });
+
+	// Latest top of book published by the matching thread, when enabled. Lock-free,
+	// never waits for the matcher or the queue, and may lag the request flow slightly
+	TopOfBook GetTopOfBook() const;
+
+	// Best depth levels of each side, tagged with the number of the last level delta
+	// they reflect. Does not wait for queued requests, so it never stalls on the flow
+	DepthSnapshot GetDepthSnapshot(std::size_t depth) const;
+
+#if defined(ORDERBOOK_LATENCY_TRACE)
+	// Latencies of the requests handled so far per stage, from the queue to the book
+	// returning from them. May be read or dumped from any thread at any time
+	const LatencyTrace& GetLatencyTrace() const { return latencyTrace_; }
+#endif
+
 	// Other public APIS - blocks until all order requests have been processed
 	void Display() const;
 	OrderBookLevelInfos GetOrderInfos() const;
@@ -60,49 +124,156 @@ public:
 
 private:
 
-	// Contains a given orderpointer and its location in the bids or asks map
-	struct OrderEntry
-	{
-		OrderPointer order_{ nullptr };
-		OrderPointers::iterator location_;
-	};
+	// Global mutex to protect orderbook during add, modify and cancel order events,
+	// a no-op when inline
+	mutable typename Threading::Mutex ordersMutex_;
 
-	// Contains aggregate quantity and order count for a given price in the orderbook
-	struct LevelDepth
-	{
-		Quantity quantity_{ };
-		Quantity count_{ };
-	};
+	// Price levels for bids (best is highest) and asks (best is lowest), each carrying
+	// the aggregate quantity and order count of its orders
+	std::unique_ptr<PriceLevels> bids_;
+	std::unique_ptr<PriceLevels> asks_;
+
+	// Owns every resting order, orders are linked into their level intrusively
+	OrderPool orderPool_;
+
+	// Map of ids to orders for quick lookup / deletion
+	OrderIdMap orders_;
+
+	// Symbol stamped on requests queued through this book
+	SymbolId symbolId_;
+
+	// Destination of execution reports, and the sequence number of the event being
+	// handled which they are tagged with
+	ExecutionReportSink* reportSink_;
+	std::uint64_t eventSequence_{ 0 };
+
+	// Destination of the audit log, the FileLogger is used when null. Nothing is
+	// logged while a journal is replayed, or at all when the audit log is off
+	Journal* journal_;
+	bool auditLog_;
+	bool replaying_{ false };
+
+	// Destination of level deltas, and the number of the last delta published
+	MarketDataFeed* marketDataFeed_;
+	std::uint64_t deltaSequence_{ 0 };
+
+	// Top of book republished after every request that changed a level, if enabled
+	Seqlock<TopOfBook> topOfBook_;
+	bool publishTopOfBook_;
+	bool depthChanged_{ false };
 
-	// Global mutex to protect orderbook during add, modify and cancel order events
-	mutable std::mutex ordersMutex_;
+#if defined(ORDERBOOK_LATENCY_TRACE)
+	// Stage latencies, and the ticks spent logging by the request being handled
+	LatencyTrace latencyTrace_;
+	std::uint64_t loggingTicks_{ 0 };
+#endif
 
-	// Map of prices to orders for bids and asks
-	std::map<Price, OrderPointers, std::greater<Price>> bids_;
-	std::map<Price, OrderPointers, std::less<Price>> asks_;
+	// Outcome of the request being handled, recorded when inline or when its
+	// producer awaits a completion
+	OrderResult result_;
+	bool recordResult_{ false };
 
-	// Map of ids to orders and iterator for quick lookup / deletion
-	std::unordered_map<OrderId, OrderEntry> orders_;
+	// Completion rings of the registered producers, indexed by producer id
+	std::vector<CompletionRing*> completionRings_{ nullptr };
 
-	// Map of prices to level information
-	std::unordered_map<Price, LevelDepth> levels_;
+	// Manages order requests and processes them synchronously in a thread-safe manner,
+	// either owned by this book or shared with the other books of a matching thread.
+	// Null when inline
+	std::unique_ptr<QueueManager> ownQueue_;
+	QueueManager* queueManager_;
 
-	// Manages order requests and processes them synchronously in a thread-safe manner
-	QueueManager queueManager_;
+	BasicOrderBook(const OrderBookConfig& config, QueueManager* sharedQueue);
+
+	// Handles a request made inline, sequenced after the last one handled
+	template <typename T> const OrderResult& HandleInline(const T& payload);
+
+	// Builds the level infos of both sides, the caller holds the orderbook lock
+	OrderBookLevelInfos GetOrderInfosInternal() const;
 
 	// Handles new order requests in the orderbook
-	Trades AddOrderInternal(const AddOrderPayload& payload);
-	Trades ModifyOrderInternal(const ModifyOrderPayload& payload);
+	void HandleEventInternal(const QueueEvent& event);
+	template <typename T> void HandleRequestInternal(const T& payload);
+
+	void AddOrderInternal(const AddOrderPayload& payload);
+	void ModifyOrderInternal(const ModifyOrderPayload& payload);
 	void CancelOrderInternal(const CancelOrderPayload& payload);
+	void CancelOrderInternal(OrderPointer order);
+
+	// Pushes the outcome of a handled request to the completion ring of its producer
+	void CompleteRequestInternal(const QueueEvent& event);
+
+	// Whether the outcome of the request being handled is recorded into result_
+	bool RecordsResult() const
+	{
+		if constexpr (Threading::Queued) return recordResult_;
+		else return true;
+	}
+
+#if defined(ORDERBOOK_LATENCY_TRACE)
+	// Records the stage latencies of a request the book has just returned from
+	void TraceEventInternal(std::uint64_t startedAt, std::uint64_t enqueuedAt = 0, std::uint64_t dequeuedAt = 0);
+#endif
+
+	// Amends a resting order, reducing it in place or moving it to a new level
+	void ReduceOrderInternal(OrderPointer order, Quantity quantity);
+	void MoveOrderInternal(OrderPointer order, Side side, Price price, Quantity quantity);
+
+	// Inserts an order at the back of its level, or takes it off its level
+	void RestOrderInternal(OrderPointer order);
+	void RemoveFromLevelInternal(OrderPointer order);
+
+	// Reapplies the requests a journal recorded for this book after a given sequence
+	void ReplayJournalInternal(const std::filesystem::path& journalPath, std::uint64_t sequence);
 	
-	// Matches new or modified orders
-	Trades MatchOrdersInternal();
+	// Matches a new or modified order against the opposite side before it rests
+	void MatchOrdersInternal(OrderPointer order);
+
+	// Matching kernels instantiated per side and order type, so that comparators and
+	// order type policies are fixed at compile time. The runtime side and type of a
+	// request are dispatched once, on entry to AddOrderInternal
+	template <Side S> void DispatchAddOrder(const AddOrderPayload& payload);
+	template <Side S, OrderType T> void AddOrderKernel(const AddOrderPayload& payload);
+	template <Side S> void MatchOrdersKernel(OrderPointer order);
+	template <Side S> bool CanMatchKernel(Price price) const;
+	template <Side S> bool CanBeFullyFilledKernel(Price price, Quantity quantity) const;
+	template <Side S> void UpdateLevelsKernel(Price price, Quantity quantity, OrderEvent event);
 
-	bool CanMatchInternal(Side side, Price price) const;
-	bool CanBeFullyFilledInternal(Side side, Price price, Quantity quantity) const;
+	// Publish execution reports to the sink, if any
+	void ReportFill(OrderPointer order, OrderPointer counterparty, Quantity quantity);
+	void ReportCancel(OrderPointer order);
+	void ReportReject(OrderId orderId, Side side, Price price, Quantity quantity, RejectReason reason);
 
-	void UpdateLevelsInternal(Price price, Quantity quantity, OrderEvent event);
+	// Writes an audit record to the journal, or its formatted message to the FileLogger
+	void LogInternal(JournalEvent event, OrderId orderId = { });
+	void LogInternal(JournalEvent event, OrderPointer order);
+	void LogInternal(JournalRecord record);
+
+	void UpdateLevelsInternal(Side side, Price price, Quantity quantity, OrderEvent event);
 	void UpdateLevelOnAddOrder(OrderPointer order);
 	void UpdateLevelOnCancelOrder(OrderPointer order);
-	void UpdateLevelOnMatchOrders(Price price, Quantity quantity, bool isFullyFilled);
-};
\ No newline at end of file
+
+	// Publishes the new state of a level to the market data feed, if any
+	void PublishDelta(Side side, Price price, const PriceLevel& level);
+
+	void PublishTopOfBookInternal();
+
+	template <Side S>
+	PriceLevels& LevelsOf()
+	{
+		if constexpr (S == Side::Buy) return *bids_;
+		else return *asks_;
+	}
+
+	template <Side S>
+	const PriceLevels& LevelsOf() const
+	{
+		if constexpr (S == Side::Buy) return *bids_;
+		else return *asks_;
+	}
+};
+
+extern template class BasicOrderBook<QueuedThreading>;
+extern template class BasicOrderBook<InlineThreading>;
+
+using OrderBook = BasicOrderBook<QueuedThreading>;
+using InlineOrderBook = BasicOrderBook<InlineThreading>;
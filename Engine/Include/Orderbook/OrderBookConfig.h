@@ -0,0 +1,57 @@
+#pragma once
+
+#include <cstddef>
+
+#include "PriceLevels.h"
+#include "OrderIdMap.h"
+#include "../Queue/QueueConfig.h"
+
+class ExecutionReportSink;
+class Journal;
+class MarketDataFeed;
+
+// Construction-time options for the OrderBook, defaults match the original engine
+
+struct OrderBookConfig
+{
+	// Storage for the bid and ask price levels
+	LevelStorage levelStorage_{ LevelStorage::Map };
+
+	// Number of ticks covered by the ladder window when using ladder storage
+	std::size_t ladderTicks_{ 4096 };
+
+	// Lookup mode for order ids, direct mode expects small sequential ids
+	OrderIdMapMode orderIdMapMode_{ OrderIdMapMode::Hashed };
+
+	// Largest order id the direct mode takes, adds of larger ids are rejected so that
+	// the id vector stays bounded whatever ids clients send
+	OrderId maxOrderId_{ 1 << 20 };
+
+	// Number of resting orders to preallocate storage and id slots for
+	std::size_t reservedOrders_{ 0 };
+
+	// Transport and wait strategy for the order request queue
+	QueueConfig queue_{ };
+
+	// Instrument traded in the book, stamped on the requests it queues
+	SymbolId symbolId_{ 0 };
+
+	// Receives fills, cancels and rejects, not owned. Reporting is off when null
+	ExecutionReportSink* reportSink_{ nullptr };
+
+	// Receives the audit log as binary records, not owned. The book logs formatted
+	// text through the FileLogger when null
+	Journal* journal_{ nullptr };
+
+	// Whether the book keeps an audit log at all, benchmarks timing single operations
+	// turn it off
+	bool auditLog_{ true };
+
+	// Receives a delta for every change to a price level, not owned. Publishing is
+	// off when null
+	MarketDataFeed* marketDataFeed_{ nullptr };
+
+	// Republishes the best levels after every request that changes them, for readers
+	// of GetTopOfBook
+	bool publishTopOfBook_{ false };
+};
@@ -0,0 +1,222 @@
+#pragma once
+
+#include <algorithm>
+#include <bit>
+#include <cstdint>
+#include <limits>
+#include <string_view>
+#include <vector>
+
+#include "Using.h"
+#include "Order.h"
+
+// Lookup modes for the OrderIdMap
+
+enum class OrderIdMapMode
+{
+	Hashed,	// Robin Hood open addressing, for arbitrary ids
+	Direct,	// Vector indexed by id, for venues handing out sequential ids
+};
+
+inline std::string_view OrderIdMapModeToString(OrderIdMapMode mode)
+{
+	switch (mode)
+	{
+	case OrderIdMapMode::Hashed: return "Hashed";
+	case OrderIdMapMode::Direct: return "Direct";
+	default: return "N/A";
+	}
+}
+
+// Flat map of order ids to resting orders. The hashed mode uses Robin Hood probing,
+// which keeps probe sequences short enough that most lookups hit the first slot,
+// and backward-shift deletion, so erasing never leaves tombstones behind. The
+// direct mode grows a vector to cover the largest id seen, up to a fixed maximum id
+
+class OrderIdMap
+{
+public:
+
+	explicit OrderIdMap(OrderIdMapMode mode = OrderIdMapMode::Hashed, OrderId maxDirectId = std::numeric_limits<OrderId>::max())
+		: mode_{ mode }
+		, maxDirectId_{ maxDirectId }
+	{
+		if (mode_ == OrderIdMapMode::Hashed) Rehash(MinCapacity);
+	}
+
+	std::size_t Size() const { return size_; }
+	bool Empty() const { return size_ == 0; }
+
+	// Whether an order with the given id can be inserted, the direct mode takes ids up
+	// to its maximum only
+
+	bool Accepts(OrderId id) const
+	{
+		return mode_ != OrderIdMapMode::Direct || id <= maxDirectId_;
+	}
+
+	// Presizes the map so that it can hold count orders (or ids up to count in the
+	// direct mode) without growing
+
+	void Reserve(std::size_t count)
+	{
+		if (mode_ == OrderIdMapMode::Direct)
+		{
+			const std::size_t ids = std::min<std::size_t>(count, maxDirectId_) + 1;
+			if (ids > direct_.size()) direct_.resize(ids, nullptr);
+			return;
+		}
+
+		std::size_t capacity = MinCapacity;
+		while (capacity * MaxLoadNumerator < count * MaxLoadDenominator) capacity *= 2;
+		if (capacity > slots_.size()) Rehash(capacity);
+	}
+
+	// Returns the order with the given id, or nullptr if it does not exist
+
+	OrderPointer Find(OrderId id) const
+	{
+		if (mode_ == OrderIdMapMode::Direct)
+			return id < direct_.size() ? direct_[id] : nullptr;
+
+		// Stop once the probe is further from home than the resident entry would be
+
+		std::size_t index = Home(id);
+		for (std::size_t distance = 0; ; ++distance, index = Next(index))
+		{
+			const auto& slot = slots_[index];
+			if (!slot.order_ || Distance(slot, index) < distance) return nullptr;
+			if (slot.id_ == id) return slot.order_;
+		}
+	}
+
+	bool Contains(OrderId id) const { return Find(id) != nullptr; }
+
+	// Inserts a new order, returns false if the id already exists or is not accepted
+
+	bool Insert(OrderId id, OrderPointer order)
+	{
+		if (mode_ == OrderIdMapMode::Direct)
+		{
+			if (!Accepts(id)) return false;
+			if (id >= direct_.size())
+				direct_.resize(std::max<std::size_t>(id + 1, std::min<std::size_t>(direct_.size() * 2, maxDirectId_)), nullptr);
+			if (direct_[id]) return false;
+			direct_[id] = order;
+			++size_;
+			return true;
+		}
+
+		if (Contains(id)) return false;
+
+		if ((size_ + 1) * MaxLoadDenominator > slots_.size() * MaxLoadNumerator)
+			Rehash(slots_.size() * 2);
+
+		Place(Slot{ id, order });
+		++size_;
+		return true;
+	}
+
+	// Removes an order, returns false if the id does not exist
+
+	bool Erase(OrderId id)
+	{
+		if (mode_ == OrderIdMapMode::Direct)
+		{
+			if (id >= direct_.size() || !direct_[id]) return false;
+			direct_[id] = nullptr;
+			--size_;
+			return true;
+		}
+
+		std::size_t index = Home(id);
+		for (std::size_t distance = 0; ; ++distance, index = Next(index))
+		{
+			const auto& slot = slots_[index];
+			if (!slot.order_ || Distance(slot, index) < distance) return false;
+			if (slot.id_ == id) break;
+		}
+
+		// Shift the following displaced entries back by one slot to close the gap
+
+		std::size_t next = Next(index);
+		while (slots_[next].order_ && Distance(slots_[next], next) > 0)
+		{
+			slots_[index] = slots_[next];
+			index = next;
+			next = Next(next);
+		}
+
+		slots_[index] = Slot{ };
+		--size_;
+		return true;
+	}
+
+private:
+
+	struct Slot
+	{
+		OrderId id_{ 0 };
+		OrderPointer order_{ nullptr };
+	};
+
+	static constexpr std::size_t MinCapacity = 16;
+	static constexpr std::size_t MaxLoadNumerator = 7;
+	static constexpr std::size_t MaxLoadDenominator = 8;
+
+	// Fibonacci hashing spreads sequential ids across the whole table
+
+	std::size_t Home(OrderId id) const
+	{
+		return static_cast<std::size_t>((id * 0x9E3779B97F4A7C15ull) >> shift_);
+	}
+
+	std::size_t Next(std::size_t index) const { return (index + 1) & (slots_.size() - 1); }
+
+	std::size_t Distance(const Slot& slot, std::size_t index) const
+	{
+		return (index - Home(slot.id_)) & (slots_.size() - 1);
+	}
+
+	// Robin Hood insertion - an entry further from home takes the slot of a richer one
+
+	void Place(Slot slot)
+	{
+		std::size_t index = Home(slot.id_);
+		for (std::size_t distance = 0; ; ++distance, index = Next(index))
+		{
+			auto& resident = slots_[index];
+			if (!resident.order_)
+			{
+				resident = slot;
+				return;
+			}
+
+			const std::size_t residentDistance = Distance(resident, index);
+			if (residentDistance < distance)
+			{
+				std::swap(resident, slot);
+				distance = residentDistance;
+			}
+		}
+	}
+
+	void Rehash(std::size_t capacity)
+	{
+		auto previous = std::move(slots_);
+		slots_.assign(capacity, Slot{ });
+		shift_ = 64 - std::countr_zero(capacity);
+
+		for (const auto& slot : previous)
+			if (slot.order_) Place(slot);
+	}
+
+	OrderIdMapMode mode_;
+	OrderId maxDirectId_;
+	std::size_t size_{ 0 };
+
+	std::vector<Slot> slots_;
+	int shift_{ 64 };
+
+	std::vector<OrderPointer> direct_;
+};
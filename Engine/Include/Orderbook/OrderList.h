@@ -0,0 +1,109 @@
+#pragma once
+
+#include <cstddef>
+#include <iterator>
+
+#include "Order.h"
+
+// Intrusive FIFO of the orders resting at a price level, linked through the
+// orders themselves. The list does not own its orders and never allocates
+
+class OrderList
+{
+public:
+
+	class Iterator
+	{
+	public:
+		using iterator_category = std::forward_iterator_tag;
+		using value_type = OrderPointer;
+		using difference_type = std::ptrdiff_t;
+		using pointer = const OrderPointer*;
+		using reference = OrderPointer;
+
+		Iterator() = default;
+		explicit Iterator(OrderPointer order) : order_{ order } { }
+
+		OrderPointer operator*() const { return order_; }
+		Iterator& operator++() { order_ = order_->next_; return *this; }
+		Iterator operator++(int) { auto it = *this; ++*this; return it; }
+		bool operator==(const Iterator& other) const = default;
+
+	private:
+		OrderPointer order_{ nullptr };
+	};
+
+	OrderList() = default;
+
+	OrderList(const OrderList&) = delete;
+	OrderList& operator=(const OrderList&) = delete;
+
+	OrderList(OrderList&& other) noexcept
+		: head_{ other.head_ }
+		, tail_{ other.tail_ }
+		, size_{ other.size_ }
+	{
+		other.clear();
+	}
+
+	OrderList& operator=(OrderList&& other) noexcept
+	{
+		head_ = other.head_;
+		tail_ = other.tail_;
+		size_ = other.size_;
+		other.clear();
+		return *this;
+	}
+
+	bool empty() const { return head_ == nullptr; }
+	std::size_t size() const { return size_; }
+	OrderPointer front() const { return head_; }
+	OrderPointer back() const { return tail_; }
+
+	Iterator begin() const { return Iterator{ head_ }; }
+	Iterator end() const { return Iterator{ }; }
+
+	void push_back(OrderPointer order)
+	{
+		order->prev_ = tail_;
+		order->next_ = nullptr;
+
+		if (tail_) tail_->next_ = order;
+		else head_ = order;
+
+		tail_ = order;
+		++size_;
+	}
+
+	void pop_front()
+	{
+		erase(head_);
+	}
+
+	void erase(OrderPointer order)
+	{
+		if (order->prev_) order->prev_->next_ = order->next_;
+		else head_ = order->next_;
+
+		if (order->next_) order->next_->prev_ = order->prev_;
+		else tail_ = order->prev_;
+
+		order->prev_ = order->next_ = nullptr;
+		--size_;
+	}
+
+	// Forgets the linked orders without touching them
+
+	void clear()
+	{
+		head_ = tail_ = nullptr;
+		size_ = 0;
+	}
+
+private:
+	OrderPointer head_{ nullptr };
+	OrderPointer tail_{ nullptr };
+	std::size_t size_{ 0 };
+};
+
+using OrderPointers = OrderList;
@@ -18,11 +18,6 @@ public:
 	Price GetPrice() const { return price_; }
 	Quantity GetQuantity() const { return quantity_; }
 
-	OrderPointer ToOrderPointer(OrderType type) const
-	{
-		return std::make_shared<Order>(GetOrderId(), type, GetSide(), GetPrice(), GetQuantity());
-	}
-
 private:
 	OrderId orderId_;
 	Side side_;
@@ -0,0 +1,80 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <vector>
+
+#include "Order.h"
+
+// Slab allocator for Order objects. Orders are carved out of fixed-size slabs and
+// recycled through a free list, so the steady state performs no heap allocations
+
+class OrderPool
+{
+public:
+
+	explicit OrderPool(std::size_t slabSize = 4096)
+		: slabSize_{ slabSize }
+	{
+	}
+
+	OrderPool(const OrderPool&) = delete;
+	OrderPool(OrderPool&&) = delete;
+	OrderPool& operator=(const OrderPool&) = delete;
+	OrderPool& operator=(OrderPool&&) = delete;
+
+	template <typename... Args>
+	OrderPointer Acquire(Args&&... args)
+	{
+		if (free_.empty()) AddSlab(slabSize_);
+
+		void* slot = free_.back();
+		free_.pop_back();
+		return ::new (slot) Order(std::forward<Args>(args)...);
+	}
+
+	void Release(OrderPointer order)
+	{
+		order->~Order();
+		free_.push_back(order);
+	}
+
+	// Preallocates slabs until the pool can hold the given number of orders
+
+	void Reserve(std::size_t capacity)
+	{
+		if (capacity > capacity_) AddSlab(capacity - capacity_);
+	}
+
+	std::size_t Capacity() const { return capacity_; }
+	std::size_t InUse() const { return capacity_ - free_.size(); }
+
+private:
+
+	// Orders hold no resources, so slabs can be released without destroying them
+	static_assert(std::is_trivially_destructible_v<Order>);
+
+	struct Slot
+	{
+		alignas(Order) std::byte bytes_[sizeof(Order)];
+	};
+
+	void AddSlab(std::size_t size)
+	{
+		auto& slab = slabs_.emplace_back(std::make_unique<Slot[]>(size));
+		capacity_ += size;
+
+		// Size the free list for every slot up front so Release never allocates
+
+		free_.reserve(capacity_);
+		for (std::size_t i = size; i-- > 0;)
+			free_.push_back(&slab[i]);
+	}
+
+	std::size_t slabSize_;
+	std::size_t capacity_{ 0 };
+	std::vector<std::unique_ptr<Slot[]>> slabs_;
+	std::vector<void*> free_;
+};
@@ -0,0 +1,15 @@
+#pragma once
+
+#include "Trade.h"
+#include "../Report/ExecutionReport.h"
+
+// Outcome of a request handled inline: the trades it executed in order, and why it
+// was rejected if it was
+
+struct OrderResult
+{
+	Trades trades_;
+	RejectReason rejectReason_{ RejectReason::None };
+
+	bool IsRejected() const { return rejectReason_ != RejectReason::None; }
+};
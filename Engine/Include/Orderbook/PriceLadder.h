@@ -0,0 +1,237 @@
+#pragma once
+
+#include <map>
+#include <vector>
+#include <algorithm>
+#include <functional>
+#include <type_traits>
+#include <utility>
+
+#include "PriceLevels.h"
+#include "HierarchicalBitset.h"
+#include "FenwickTree.h"
+#include "NodePool.h"
+
+// Price levels stored in a dense array indexed by tick offset from an anchor price.
+// A hierarchical bitset of occupied ticks finds the best and worst levels without
+// walking the array. Prices outside the window fall back to an ordered map, and the
+// window re-centres on the next price added (or the best overflow level) whenever
+// it runs empty, so it follows the touch as the market moves. Each tick holds its
+// orders and aggregates together, and a Fenwick tree over the window also sums the
+// quantity of the ticks so that fill-or-kill checks are logarithmic
+
+template <typename Compare>
+class PriceLadder final : public PriceLevels
+{
+public:
+
+	explicit PriceLadder(std::size_t ticks)
+		: ladder_(ticks)
+		, occupied_{ ticks }
+		, quantities_{ ticks }
+		, overflow_{ NodeAllocator<std::pair<const Price, PriceLevel>>{ overflowNodes_ } }
+	{
+	}
+
+	std::size_t Size() const override { return windowLevels_ + overflow_.size(); }
+
+	PriceLevel& GetOrCreateLevel(Price price) override
+	{
+		if (!anchored_ || (windowLevels_ == 0 && !InWindow(price)))
+			Recenter(price);
+
+		if (!InWindow(price))
+			return overflow_[price];
+
+		const auto index = IndexOf(price);
+		if (!occupied_.Test(index))
+		{
+			occupied_.Set(index);
+			++windowLevels_;
+		}
+		return ladder_[index];
+	}
+
+	PriceLevel& GetLevel(Price price) override
+	{
+		return InWindow(price) ? ladder_[IndexOf(price)] : overflow_.at(price);
+	}
+
+	void EraseLevel(Price price) override
+	{
+		if (!InWindow(price))
+		{
+			overflow_.erase(price);
+			return;
+		}
+
+		const auto index = IndexOf(price);
+		if (!occupied_.Test(index))
+			return;
+
+		ladder_[index] = PriceLevel{ };
+		occupied_.Reset(index);
+		--windowLevels_;
+
+		// Pull the window over the best overflow level once it runs empty
+
+		if (windowLevels_ == 0 && !overflow_.empty())
+			Recenter(overflow_.begin()->first);
+	}
+
+	Price BestPrice() const override
+	{
+		if (windowLevels_ == 0) return overflow_.begin()->first;
+
+		const Price windowBest = PriceOf(IsBid ? occupied_.FindLast() : occupied_.FindFirst());
+		if (overflow_.empty()) return windowBest;
+
+		const Price overflowBest = overflow_.begin()->first;
+		return Compare{}(overflowBest, windowBest) ? overflowBest : windowBest;
+	}
+
+	Price WorstPrice() const override
+	{
+		if (windowLevels_ == 0) return overflow_.rbegin()->first;
+
+		const Price windowWorst = PriceOf(IsBid ? occupied_.FindFirst() : occupied_.FindLast());
+		if (overflow_.empty()) return windowWorst;
+
+		const Price overflowWorst = overflow_.rbegin()->first;
+		return Compare{}(windowWorst, overflowWorst) ? overflowWorst : windowWorst;
+	}
+
+	PriceLevel& BestLevel() override
+	{
+		return GetLevel(BestPrice());
+	}
+
+	const PriceLevel& AddToLevel(Price price, Quantity quantity, std::uint32_t count) override
+	{
+		auto& level = GetLevel(price);
+		level.quantity_ += quantity;
+		level.count_ += count;
+
+		if (InWindow(price)) quantities_.Add(IndexOf(price), quantity);
+		return level;
+	}
+
+	const PriceLevel& RemoveFromLevel(Price price, Quantity quantity, std::uint32_t count) override
+	{
+		auto& level = GetLevel(price);
+		level.quantity_ -= quantity;
+		level.count_ -= count;
+
+		if (InWindow(price)) quantities_.Add(IndexOf(price), -static_cast<std::int64_t>(quantity));
+		return level;
+	}
+
+	bool CanFill(Price limit, Quantity quantity) const override
+	{
+		// Sum the window ticks at or better than the limit with a single prefix query,
+		// i.e. the ticks above it for bids and below it for asks
+
+		std::int64_t total = 0;
+		if (anchored_)
+		{
+			const auto ticks = static_cast<std::int64_t>(ladder_.size());
+			const auto offset = static_cast<std::int64_t>(limit) - anchor_;
+
+			total = IsBid
+				? quantities_.Total() - quantities_.PrefixSum(static_cast<std::size_t>(std::clamp<std::int64_t>(offset, 0, ticks)))
+				: quantities_.PrefixSum(static_cast<std::size_t>(std::clamp<std::int64_t>(offset + 1, 0, ticks)));
+		}
+
+		if (total >= quantity) return true;
+
+		// Add the crossed overflow levels from the best price
+
+		for (auto it = overflow_.begin(); it != overflow_.end() && !Compare{}(limit, it->first); ++it)
+		{
+			total += it->second.quantity_;
+			if (total >= quantity) return true;
+		}
+		return false;
+	}
+
+	void ForEachBestLevel(std::size_t count, const LevelVisitor& visitor) const override
+	{
+		// Merge the window and overflow levels, both already ordered best to worst
+
+		auto overflowIt = overflow_.begin();
+		auto index = windowLevels_ == 0
+			? HierarchicalBitset::npos
+			: (IsBid ? occupied_.FindLast() : occupied_.FindFirst());
+
+		while (index != HierarchicalBitset::npos)
+		{
+			const Price price = PriceOf(index);
+			for (; overflowIt != overflow_.end() && Compare{}(overflowIt->first, price); ++overflowIt)
+			{
+				if (count-- == 0) return;
+				visitor(overflowIt->first, overflowIt->second);
+			}
+
+			if (count-- == 0) return;
+			visitor(price, ladder_[index]);
+			index = IsBid ? occupied_.FindPrev(index) : occupied_.FindNext(index);
+		}
+
+		for (; overflowIt != overflow_.end() && count > 0; ++overflowIt, --count)
+			visitor(overflowIt->first, overflowIt->second);
+	}
+
+	// Pool recycling the nodes of the levels outside the window
+	const NodePool& OverflowNodes() const { return overflowNodes_; }
+
+private:
+
+	static constexpr bool IsBid = std::is_same_v<Compare, std::greater<Price>>;
+
+	bool InWindow(Price price) const
+	{
+		if (!anchored_) return false;
+		const auto offset = static_cast<std::int64_t>(price) - anchor_;
+		return offset >= 0 && offset < static_cast<std::int64_t>(ladder_.size());
+	}
+
+	std::size_t IndexOf(Price price) const { return static_cast<std::size_t>(price - anchor_); }
+	Price PriceOf(std::size_t index) const { return static_cast<Price>(anchor_ + static_cast<std::int64_t>(index)); }
+
+	// Moves the (empty) window so that it is centred on the given price, and pulls
+	// any overflow levels which now fall inside it into the ladder
+
+	void Recenter(Price price)
+	{
+		anchor_ = static_cast<std::int64_t>(price) - static_cast<std::int64_t>(ladder_.size() / 2);
+		anchored_ = true;
+
+		for (auto it = overflow_.begin(); it != overflow_.end();)
+		{
+			if (!InWindow(it->first))
+			{
+				++it;
+				continue;
+			}
+
+			const auto index = IndexOf(it->first);
+			ladder_[index] = std::move(it->second);
+			quantities_.Add(index, ladder_[index].quantity_);
+			occupied_.Set(index);
+			++windowLevels_;
+			it = overflow_.erase(it);
+		}
+	}
+
+	std::vector<PriceLevel> ladder_;
+	HierarchicalBitset occupied_;
+	FenwickTree quantities_;
+	std::size_t windowLevels_{ 0 };
+
+	std::int64_t anchor_{ 0 };
+	bool anchored_{ false };
+
+	// Levels outside the window, ordered best to worst, with their nodes recycled
+	NodePool overflowNodes_;
+	std::map<Price, PriceLevel, Compare, NodeAllocator<std::pair<const Price, PriceLevel>>> overflow_;
+};
@@ -0,0 +1,19 @@
+#pragma once
+
+#include <cstdint>
+
+#include "Using.h"
+#include "OrderList.h"
+
+// Orders resting at one price by time priority, stored next to the aggregates that
+// depth reads need, so that they never walk the orders or look the level up again
+
+struct PriceLevel
+{
+	OrderPointers orders_;
+
+	// Remaining quantity and number of the orders at this price, kept up to date by
+	// the orderbook while the level exists
+	Quantity quantity_{ 0 };
+	std::uint32_t count_{ 0 };
+};
@@ -0,0 +1,71 @@
+#pragma once
+
+#include <functional>
+#include <string_view>
+
+#include "Using.h"
+#include "PriceLevel.h"
+
+// Interface for one side of the orderbook - a collection of price levels, each
+// holding its orders by time priority along with their aggregates. Implementations
+// order levels from the best price to the worst (i.e. descending for bids and
+// ascending for asks)
+
+class PriceLevels
+{
+public:
+
+	using LevelVisitor = std::function<void(Price, const PriceLevel&)>;
+
+	virtual ~PriceLevels() = default;
+
+	// Number of non-empty price levels on this side
+	virtual std::size_t Size() const = 0;
+	bool Empty() const { return Size() == 0; }
+
+	// Returns the level at a given price, creating an empty level if necessary
+	virtual PriceLevel& GetOrCreateLevel(Price price) = 0;
+
+	// Returns an existing level, the level must exist
+	virtual PriceLevel& GetLevel(Price price) = 0;
+
+	// Removes an (empty) level from this side
+	virtual void EraseLevel(Price price) = 0;
+
+	// Best and worst prices on this side, the side must not be empty
+	virtual Price BestPrice() const = 0;
+	virtual Price WorstPrice() const = 0;
+	virtual PriceLevel& BestLevel() = 0;
+
+	// Updates the aggregates of an existing level, i.e. between GetOrCreateLevel and
+	// EraseLevel, and returns the level
+	virtual const PriceLevel& AddToLevel(Price price, Quantity quantity, std::uint32_t count) = 0;
+	virtual const PriceLevel& RemoveFromLevel(Price price, Quantity quantity, std::uint32_t count) = 0;
+
+	// Whether the levels priced at or better than limit hold at least quantity
+	virtual bool CanFill(Price limit, Quantity quantity) const = 0;
+
+	// Visits up to count levels, from the best price to the worst
+	virtual void ForEachBestLevel(std::size_t count, const LevelVisitor& visitor) const = 0;
+
+	// Visits every level from the best price to the worst
+	void ForEachLevel(const LevelVisitor& visitor) const { ForEachBestLevel(Size(), visitor); }
+};
+
+// Storage used for the price levels of each side of the orderbook
+
+enum class LevelStorage
+{
+	Map,
+	Ladder,
+};
+
+inline std::string_view LevelStorageToString(LevelStorage storage)
+{
+	switch (storage)
+	{
+	case LevelStorage::Map: return "Map";
+	case LevelStorage::Ladder: return "Ladder";
+	default: return "N/A";
+	}
+}
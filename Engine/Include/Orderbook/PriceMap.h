@@ -0,0 +1,148 @@
+#pragma once
+
+#include <array>
+#include <map>
+
+#include "PriceLevels.h"
+#include "NodePool.h"
+
+// Price levels stored in a std::map, ordered from best to worst by Compare
+// E.g. std::greater<Price> for bids and std::less<Price> for asks
+//
+// Levels near the touch empty and refill constantly, so an emptied level is left in
+// the map as a dormant level rather than erased, and is revived in place by the next
+// order at its price. The searches skip dormant levels. Only the most recently
+// emptied ones are kept, older ones are erased and their node goes back to the pool.
+// The best live level is tracked so that dormant levels at the touch are not walked
+// on every best price lookup
+
+template <typename Compare>
+class PriceMap final : public PriceLevels
+{
+public:
+
+	// Number of recently emptied levels left in the map
+	static constexpr std::size_t MaxDormantLevels = 16;
+
+	PriceMap()
+		: levels_{ NodeAllocator<std::pair<const Price, PriceLevel>>{ nodes_ } }
+		, best_{ levels_.end() }
+	{
+	}
+
+	std::size_t Size() const override { return levels_.size() - dormantLevels_; }
+
+	PriceLevel& GetOrCreateLevel(Price price) override
+	{
+		auto [it, created] = levels_.try_emplace(price);
+		if (!created && IsDormant(it->second)) --dormantLevels_;
+
+		if (best_ == levels_.end() || Compare{}(price, best_->first)) best_ = it;
+		return it->second;
+	}
+
+	PriceLevel& GetLevel(Price price) override { return levels_.at(price); }
+
+	void EraseLevel(Price price) override
+	{
+		// Evict the oldest dormant level to make room, unless it was revived since or
+		// is the level being emptied
+
+		if (dormantCount_ == dormant_.size())
+		{
+			const auto it = levels_.find(dormant_[dormantHead_]);
+			if (it != levels_.end() && it->first != price && IsDormant(it->second))
+			{
+				levels_.erase(it);
+				--dormantLevels_;
+			}
+
+			dormantHead_ = (dormantHead_ + 1) % dormant_.size();
+			--dormantCount_;
+		}
+
+		dormant_[(dormantHead_ + dormantCount_++) % dormant_.size()] = price;
+		++dormantLevels_;
+
+		// Move past the emptied level if it was the best one
+
+		while (best_ != levels_.end() && IsDormant(best_->second)) ++best_;
+	}
+
+	Price BestPrice() const override { return best_->first; }
+	Price WorstPrice() const override { return LastLevel()->first; }
+	PriceLevel& BestLevel() override { return best_->second; }
+
+	const PriceLevel& AddToLevel(Price price, Quantity quantity, std::uint32_t count) override
+	{
+		auto& level = levels_.at(price);
+		level.quantity_ += quantity;
+		level.count_ += count;
+		return level;
+	}
+
+	const PriceLevel& RemoveFromLevel(Price price, Quantity quantity, std::uint32_t count) override
+	{
+		auto& level = levels_.at(price);
+		level.quantity_ -= quantity;
+		level.count_ -= count;
+		return level;
+	}
+
+	bool CanFill(Price limit, Quantity quantity) const override
+	{
+		// Walks only the levels crossed, from the best price. Dormant levels hold no
+		// quantity so they need not be skipped
+
+		std::uint64_t total = 0;
+		for (auto it = typename Levels::const_iterator{ best_ }; it != levels_.end() && !Compare{}(limit, it->first); ++it)
+		{
+			total += it->second.quantity_;
+			if (total >= quantity) return true;
+		}
+		return false;
+	}
+
+	void ForEachBestLevel(std::size_t count, const LevelVisitor& visitor) const override
+	{
+		for (auto it = typename Levels::const_iterator{ best_ }; count > 0 && it != levels_.end(); ++it)
+		{
+			if (IsDormant(it->second)) continue;
+
+			visitor(it->first, it->second);
+			--count;
+		}
+	}
+
+	// Pool recycling the nodes of the map
+	const NodePool& Nodes() const { return nodes_; }
+
+private:
+
+	using Levels = std::map<Price, PriceLevel, Compare, NodeAllocator<std::pair<const Price, PriceLevel>>>;
+
+	// Live levels always hold an order, except between GetOrCreateLevel and the
+	// order being added to the new level
+	static bool IsDormant(const PriceLevel& level) { return level.orders_.empty(); }
+
+	// Worst live level, the side must not be empty
+
+	typename Levels::const_reverse_iterator LastLevel() const
+	{
+		auto it = levels_.rbegin();
+		while (IsDormant(it->second)) ++it;
+		return it;
+	}
+
+	NodePool nodes_;
+	Levels levels_;
+
+	// Best live level, or the end of the map when the side is empty
+	typename Levels::iterator best_;
+
+	// Prices of the emptied levels, oldest first, which may since have been revived
+	std::array<Price, MaxDormantLevels> dormant_{ };
+	std::size_t dormantHead_{ 0 };
+	std::size_t dormantCount_{ 0 };
+	std::size_t dormantLevels_{ 0 };
+};
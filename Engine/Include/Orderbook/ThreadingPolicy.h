@@ -0,0 +1,34 @@
+#pragma once
+
+#include <mutex>
+
+// Threading policies of the orderbook, chosen at compile time through the template
+// argument of BasicOrderBook
+
+// Stands in for a mutex where nothing is ever shared, locking it compiles to nothing
+
+struct NullMutex
+{
+	void lock() { }
+	bool try_lock() { return true; }
+	void unlock() { }
+};
+
+// Requests are queued by any number of producers and handled by a worker thread,
+// which is the original engine. Readers lock the book against the worker
+
+struct QueuedThreading
+{
+	static constexpr bool Queued = true;
+	using Mutex = std::mutex;
+};
+
+// Requests are handled on the calling thread as they are made and their outcome
+// returned to the caller. There is no queue and no lock, so a book is only ever
+// used from one thread at a time
+
+struct InlineThreading
+{
+	static constexpr bool Queued = false;
+	using Mutex = NullMutex;
+};
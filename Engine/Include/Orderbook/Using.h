@@ -6,4 +6,7 @@
 using Price = std::int32_t;
 using Quantity = std::uint32_t;
 using OrderId = std::uint64_t;
-using OrderIds = std::vector<OrderId>;
\ No newline at end of file
+using OrderIds = std::vector<OrderId>;
+using SymbolId = std::uint32_t;
+using ProducerId = std::uint8_t;
+using Ticket = std::uint64_t;
\ No newline at end of file
@@ -0,0 +1,144 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <span>
+#include <thread>
+#include <vector>
+
+#include "MpscRing.h"
+#include "../Util/Concurrency.h"
+
+// Values a drain thread hands to its consumer at once
+inline constexpr std::size_t DrainBatch = 256;
+
+// Preallocated multi-producer ring emptied by a drain thread of its own, which is how
+// the execution report sink, the market data feed and the journal hand records off
+// the matching threads. Pushing copies the value into the ring and never allocates,
+// so books may push from the match path, and any number of books on any matching
+// threads may share a ring. The consumer is called on the drain thread as
+// consumer(ring), takes what it can from the ring and returns the number it took
+
+template <typename T, typename Consumer>
+class DrainedRing
+{
+public:
+
+	DrainedRing(Consumer consumer, std::size_t capacity)
+		: ring_{ capacity }
+		, consumer_{ std::move(consumer) }
+		, drainThread_{ [this]() { Drain(); } }
+	{ }
+
+	~DrainedRing() { Stop(); }
+
+	DrainedRing(const DrainedRing&) = delete;
+	DrainedRing(DrainedRing&&) = delete;
+	DrainedRing& operator=(const DrainedRing&) = delete;
+	DrainedRing& operator=(DrainedRing&&) = delete;
+
+	// Producer side, spins while the consumer makes room in a full ring
+
+	void Push(const T& value)
+	{
+		while (!ring_.TryPush([&value](T& slot, std::uint64_t) { slot = value; }))
+			CpuRelax();
+	}
+
+	// Blocks until every value pushed before the call has been consumed
+
+	void Flush() const
+	{
+		const std::uint64_t target = ring_.Claimed();
+
+		std::size_t spins = 0;
+		while (consumed_.load(std::memory_order_acquire) < target)
+		{
+			if (++spins < SpinLimit) CpuRelax();
+			else std::this_thread::yield();
+		}
+	}
+
+	// Hands anything still in the ring to the consumer, then ends the drain thread.
+	// Nothing may be pushed afterwards
+
+	void Stop()
+	{
+		stop_.store(true, std::memory_order_release);
+		if (drainThread_.joinable()) drainThread_.join();
+	}
+
+private:
+
+	// Idle rounds spent spinning, then yielding, before the drain thread sleeps
+	static constexpr std::size_t SpinLimit = 1'000;
+	static constexpr std::size_t YieldLimit = 2'000;
+	static constexpr auto IdleSleep = std::chrono::microseconds(100);
+
+	MpscRing<T> ring_;
+
+	// Number of values consumed so far
+	alignas(CacheLineSize) std::atomic<std::uint64_t> consumed_{ 0 };
+
+	std::atomic<bool> stop_{ false };
+	Consumer consumer_;
+	std::thread drainThread_;
+
+	// Loop for the drain thread, backs off to sleeping while nothing arrives
+
+	void Drain()
+	{
+		std::size_t idle = 0;
+
+		while (true)
+		{
+			if (const std::size_t taken = consumer_(ring_); taken > 0)
+			{
+				consumed_.fetch_add(taken, std::memory_order_release);
+				idle = 0;
+				continue;
+			}
+
+			// Drain anything pushed before the stop request
+
+			if (stop_.load(std::memory_order_acquire))
+			{
+				if (ring_.Empty()) break;
+				continue;
+			}
+
+			if (++idle < SpinLimit) CpuRelax();
+			else if (idle < YieldLimit) std::this_thread::yield();
+			else std::this_thread::sleep_for(IdleSleep);
+		}
+	}
+};
+
+// Consumer handing up to DrainBatch values at a time to a handler
+
+template <typename T>
+class BatchHandler
+{
+public:
+
+	using Handler = std::function<void(std::span<const T>)>;
+
+	explicit BatchHandler(Handler handler)
+		: handler_{ std::move(handler) }
+		, batch_(DrainBatch)
+	{ }
+
+	std::size_t operator()(MpscRing<T>& ring)
+	{
+		const std::size_t popped = ring.TryPopBatch(batch_);
+		if (popped > 0) handler_(std::span<const T>{ batch_.data(), popped });
+		return popped;
+	}
+
+private:
+
+	Handler handler_;
+	std::vector<T> batch_;
+};
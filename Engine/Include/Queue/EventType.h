@@ -1,6 +1,8 @@
 #pragma once
 
-enum class EventType
+#include <cstdint>
+
+enum class EventType : std::uint8_t
 {
 	AddOrder,
 	ModifyOrder,
@@ -0,0 +1,148 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <utility>
+
+#include "../Util/Concurrency.h"
+
+// Bounded multi-producer / single-consumer ring buffer (after Dmitry Vyukov's
+// bounded queue). Producers claim a position with a CAS on the tail, then publish
+// their cell through its sequence number, so the consumer sees events in the
+// order their positions were claimed. That position doubles as a global arrival
+// sequence number for the event
+
+template <typename T>
+class MpscRing
+{
+public:
+
+	explicit MpscRing(std::size_t capacity)
+		: capacity_{ std::bit_ceil(capacity < 2 ? std::size_t{ 2 } : capacity) }
+		, mask_{ capacity_ - 1 }
+		, cells_{ std::make_unique<Cell[]>(capacity_) }
+	{
+		for (std::size_t i = 0; i < capacity_; ++i)
+			cells_[i].sequence_.store(i, std::memory_order_relaxed);
+	}
+
+	MpscRing(const MpscRing&) = delete;
+	MpscRing(MpscRing&&) = delete;
+	MpscRing& operator=(const MpscRing&) = delete;
+	MpscRing& operator=(MpscRing&&) = delete;
+
+	std::size_t Capacity() const { return capacity_; }
+
+	// Number of positions claimed by producers so far, published or not
+	std::uint64_t Claimed() const { return tail_.load(std::memory_order_acquire); }
+
+	bool Empty() const { return head_ == tail_.load(std::memory_order_acquire); }
+
+	// Producer side, safe to call from any number of threads. The writer fills the
+	// claimed cell in place and receives its position. Returns false if full
+
+	template <typename Writer>
+	bool TryPush(Writer&& writer)
+	{
+		return TryPushBatch(1, std::forward<Writer>(writer)) == 1;
+	}
+
+	// Claims a run of up to count consecutive positions with a single CAS, so a
+	// batch is never interleaved with another producer's events. Returns the number
+	// of cells written, which is 0 if the ring is full
+
+	template <typename Writer>
+	std::size_t TryPushBatch(std::size_t count, Writer&& writer)
+	{
+		count = std::min(count, capacity_);
+		std::size_t position = tail_.load(std::memory_order_relaxed);
+		std::size_t claimed;
+
+		while (true)
+		{
+			const std::size_t sequence = cells_[position & mask_].sequence_.load(std::memory_order_acquire);
+			const auto difference = static_cast<std::ptrdiff_t>(sequence - position);
+
+			if (difference < 0)
+				return 0;
+
+			if (difference > 0)
+			{
+				position = tail_.load(std::memory_order_relaxed);
+				continue;
+			}
+
+			// The consumer frees cells in order, so the run is free up to the last
+			// cell whose sequence matches its position
+
+			claimed = count;
+			while (claimed > 1 && !IsFree(position + claimed - 1))
+				--claimed;
+
+			if (tail_.compare_exchange_weak(position, position + claimed, std::memory_order_relaxed))
+				break;
+		}
+
+		for (std::size_t i = 0; i < claimed; ++i)
+		{
+			Cell& cell = cells_[(position + i) & mask_];
+			writer(cell.value_, static_cast<std::uint64_t>(position + i));
+			cell.sequence_.store(position + i + 1, std::memory_order_release);
+		}
+
+		return claimed;
+	}
+
+	// Consumer side, returns false if the next cell has not been published yet
+
+	bool TryPop(T& value)
+	{
+		return TryPopBatch(std::span<T>{ &value, 1 }) == 1;
+	}
+
+	// Pops up to values.size() consecutive published cells, returns the number popped
+
+	std::size_t TryPopBatch(std::span<T> values)
+	{
+		std::size_t popped = 0;
+		for (; popped < values.size(); ++popped, ++head_)
+		{
+			Cell& cell = cells_[head_ & mask_];
+			if (cell.sequence_.load(std::memory_order_acquire) != head_ + 1)
+				break;
+
+			values[popped] = std::move(cell.value_);
+			cell.sequence_.store(head_ + capacity_, std::memory_order_release);
+		}
+
+		return popped;
+	}
+
+private:
+
+	struct Cell
+	{
+		std::atomic<std::size_t> sequence_;
+		T value_;
+	};
+
+	bool IsFree(std::size_t position) const
+	{
+		return cells_[position & mask_].sequence_.load(std::memory_order_acquire) == position;
+	}
+
+	std::size_t capacity_;
+	std::size_t mask_;
+	std::unique_ptr<Cell[]> cells_;
+
+	// Contended by every producer
+	alignas(CacheLineSize) std::atomic<std::size_t> tail_{ 0 };
+
+	// Only touched by the consumer
+	alignas(CacheLineSize) std::size_t head_{ 0 };
+};
@@ -1,7 +1,5 @@
 #pragma once
 
-#include <variant>
-
 #include "../Orderbook/Using.h"
 #include "../Enum/Side.h"
 #include "../Enum/OrderType.h"
@@ -14,6 +12,7 @@ struct AddOrderPayload
 	Side side_;
 	Price price_;
 	Quantity quantity_;
+	SymbolId symbolId_{ };
 };
 
 struct ModifyOrderPayload
@@ -22,11 +21,11 @@ struct ModifyOrderPayload
 	Side side_;
 	Price price_;
 	Quantity quantity_;
+	SymbolId symbolId_{ };
 };
 
 struct CancelOrderPayload
 {
 	OrderId orderId_;
-};
-
-using Payload = std::variant<AddOrderPayload, ModifyOrderPayload, CancelOrderPayload>;
\ No newline at end of file
+	SymbolId symbolId_{ };
+};
\ No newline at end of file
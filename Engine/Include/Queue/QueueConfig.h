@@ -0,0 +1,60 @@
+#pragma once
+
+#include <cstddef>
+#include <string_view>
+
+// Transport used to hand events from the producer to the QueueManager's worker thread
+
+enum class QueueMode
+{
+	Locked,	// std::queue guarded by a mutex, safe for any number of producers
+	Spsc,	// Bounded lock-free ring, requires a single producer thread
+	Mpsc,	// Bounded lock-free ring, safe for any number of producers
+};
+
+// How a thread waits for events to arrive or to finish processing
+
+enum class WaitStrategy
+{
+	BusySpin,	// Lowest latency, burns a core while idle
+	SpinYield,	// Spins briefly, then yields the time slice
+	Park,		// Spins briefly, then sleeps on the atomic (futex / WaitOnAddress)
+};
+
+inline std::string_view QueueModeToString(QueueMode mode)
+{
+	switch (mode)
+	{
+	case QueueMode::Locked: return "Locked";
+	case QueueMode::Spsc: return "Spsc";
+	case QueueMode::Mpsc: return "Mpsc";
+	default: return "N/A";
+	}
+}
+
+inline std::string_view WaitStrategyToString(WaitStrategy strategy)
+{
+	switch (strategy)
+	{
+	case WaitStrategy::BusySpin: return "BusySpin";
+	case WaitStrategy::SpinYield: return "SpinYield";
+	case WaitStrategy::Park: return "Park";
+	default: return "N/A";
+	}
+}
+
+struct QueueConfig
+{
+	QueueMode mode_{ QueueMode::Locked };
+	WaitStrategy waitStrategy_{ WaitStrategy::Park };
+
+	// Number of events the ring can hold, rounded up to a power of two
+	std::size_t capacity_{ 1 << 16 };
+
+	// Maximum number of events the worker drains per wakeup and hands to the
+	// handler at once, so the book lock is taken once per batch
+	std::size_t batchSize_{ 64 };
+
+	// Core the worker thread is pinned to, -1 leaves placement to the scheduler
+	int core_{ -1 };
+};
@@ -1,14 +1,91 @@
 #pragma once
 
-#include <variant>
+#include <cstdint>
+#include <stdexcept>
+#include <type_traits>
 
 #include "Payload.h"
 #include "EventType.h"
 
-// Struct to encapsulate order request information to the Orderbook
+// Struct to encapsulate order request information to the Orderbook. A fixed size,
+// trivially copyable record tagged with the request type, so queues and rings copy
+// it as plain bytes and two fit in a cache line. The requests nest (a cancel names
+// an order, a modify adds its side, price and quantity, an add also its type), so
+// each field is laid out once and the tag says which of them are set
 
-struct QueueEvent
+struct alignas(32) QueueEvent
 {
-	EventType event_;
-	Payload payload_;
-};
\ No newline at end of file
+	QueueEvent() = default;
+
+	explicit QueueEvent(const AddOrderPayload& payload)
+		: orderId_{ payload.orderId_ }
+		, price_{ payload.price_ }
+		, quantity_{ payload.quantity_ }
+		, symbolId_{ payload.symbolId_ }
+		, event_{ EventType::AddOrder }
+		, orderType_{ payload.orderType_ }
+		, side_{ payload.side_ }
+	{ }
+
+	explicit QueueEvent(const ModifyOrderPayload& payload)
+		: orderId_{ payload.orderId_ }
+		, price_{ payload.price_ }
+		, quantity_{ payload.quantity_ }
+		, symbolId_{ payload.symbolId_ }
+		, event_{ EventType::ModifyOrder }
+		, side_{ payload.side_ }
+	{ }
+
+	explicit QueueEvent(const CancelOrderPayload& payload)
+		: orderId_{ payload.orderId_ }
+		, symbolId_{ payload.symbolId_ }
+		, event_{ EventType::CancelOrder }
+	{ }
+
+	// Calls visitor with the payload of the request, switching on the tag
+	template <typename Visitor>
+	decltype(auto) Visit(Visitor&& visitor) const
+	{
+		switch (event_)
+		{
+		case EventType::AddOrder:
+			return visitor(AddOrderPayload{ orderId_, orderType_, side_, price_, quantity_, symbolId_ });
+		case EventType::ModifyOrder:
+			return visitor(ModifyOrderPayload{ orderId_, side_, price_, quantity_, symbolId_ });
+		case EventType::CancelOrder:
+			return visitor(CancelOrderPayload{ orderId_, symbolId_ });
+		default:
+			throw std::logic_error("Unsupported event.");
+		}
+	}
+
+	// Global arrival order, stamped by the QueueManager at enqueue starting from 1
+	std::uint64_t sequence_{ 0 };
+
+	OrderId orderId_{ };
+	Price price_{ };
+	Quantity quantity_{ };
+
+	// Symbol the order request is for, used by the Exchange to route it to its book
+	SymbolId symbolId_{ };
+
+	EventType event_{ };
+	OrderType orderType_{ };
+	Side side_{ };
+
+	// Producer whose completion ring receives the outcome of the request, 0 for none
+	ProducerId producer_{ 0 };
+
+#if defined(ORDERBOOK_LATENCY_TRACE)
+	// ReadTimestamp values taken by the QueueManager when the request was enqueued
+	// and when the worker thread dequeued it
+	std::uint64_t enqueuedAt_{ 0 };
+	std::uint64_t dequeuedAt_{ 0 };
+#endif
+};
+
+static_assert(std::is_trivially_copyable_v<QueueEvent>);
+
+#if !defined(ORDERBOOK_LATENCY_TRACE)
+static_assert(sizeof(QueueEvent) == 32);
+#endif
\ No newline at end of file
@@ -4,17 +4,31 @@
 #include <mutex>
 #include <condition_variable>
 #include <thread>
-#include <functional>
+#include <concepts>
 #include <iostream>
 #include <future>
+#include <atomic>
+#include <memory>
+#include <span>
+#include <vector>
 
 #include "QueueEvent.h"
+#include "QueueConfig.h"
+#include "SpscRing.h"
+#include "MpscRing.h"
+#include "../Util/Concurrency.h"
+#include "../Util/LatencyTrace.h"
 
 class QueueManager
 {
 public:
 
-	explicit QueueManager(std::function<void(const QueueEvent&)> eventHandler);
+	// Starts a worker thread handing batches of events to handler, which is called
+	// through its own type rather than a type-erased wrapper so that it is inlined
+	// into the worker loop
+	template <typename Handler>
+		requires std::invocable<Handler&, std::span<const QueueEvent>>
+	explicit QueueManager(Handler handler, const QueueConfig& config = {});
 	~QueueManager();
 
 	QueueManager(const QueueManager&) = delete;
@@ -22,23 +36,183 @@ public:
 	QueueManager& operator=(const QueueManager&) = delete;
 	QueueManager& operator=(QueueManager&&) = delete;
 
-	// Enqueues an order request to the queue
-	void EnqueueEvent(const QueueEvent& event);
+	// Enqueues an order request to the queue, returns its arrival sequence number
+	std::uint64_t EnqueueEvent(const QueueEvent& event);
 
-	// Blocks until all events in the queue have been processed
+	// Enqueues a burst of order requests with one synchronization on the queue,
+	// returns the arrival sequence number of the last one
+	std::uint64_t EnqueueEvents(std::span<const QueueEvent> events);
+
+	// Blocks until every event enqueued before the call has been processed
 	void WaitForAllEvents() const;
 
+	// Whether every event enqueued so far has been processed
+	bool Idle() const;
+
+	// Numbers the events enqueued from now on after sequence, so that a book recovered
+	// up to it carries on where it left off. Has no effect if events were already
+	// numbered past it, throws unless the queue is idle
+	void ResumeFrom(std::uint64_t sequence);
+
 private:
 
+	QueueConfig config_;
+
+	// Locked mode
 	std::queue<QueueEvent> eventQueue_;
 	mutable std::mutex queueMutex_;
 	mutable std::condition_variable condition_;
+
+	// Spsc mode
+	std::unique_ptr<SpscRing<QueueEvent>> ring_;
+
+	// Mpsc mode, the ring hands out the arrival sequence numbers itself
+	std::unique_ptr<MpscRing<QueueEvent>> mpscRing_;
+
+	// Offset of the arrival sequence numbers from the ring positions (ring modes)
+	std::atomic<std::uint64_t> ringSequenceBase_{ 0 };
+
+	// Sequence numbers of the last event enqueued (Locked mode) and the last event
+	// processed
+	alignas(CacheLineSize) std::atomic<std::uint64_t> enqueued_{ 0 };
+	alignas(CacheLineSize) mutable std::atomic<std::uint64_t> processed_{ 0 };
+	mutable std::atomic<std::uint32_t> waiters_{ 0 };
+
+	// Lets a parked worker thread sleep until a producer (or shutdown) signals it
+	alignas(CacheLineSize) std::atomic<bool> workerParked_{ false };
+	std::atomic<std::uint32_t> workerSignal_{ 0 };
+
+	std::atomic<bool> stopQueueManager_;
 	std::thread workerThread_;
-	bool stopQueueManager_;
 
-	// Callback function provided by OrderBook to process QueueEvent objects
-	std::function<void(const QueueEvent&)> eventHandler_;
+	// Sets up the queue of the configured mode, before the worker thread starts
+	explicit QueueManager(const QueueConfig& config);
+
+	// Pins the started worker thread to the configured core, if any
+	void PinWorker();
+
+	// Loop for worker threads to fetch QueueEvent objects and pass them to the handler
+	// provided by the OrderBook or Exchange
+	template <typename Handler>
+	void HandleEvents(Handler& handler);
+
+	template <typename Handler>
+	void HandleLockedEvents(Handler& handler);
+
+	template <typename Handler, typename Ring>
+	void HandleRingEvents(Handler& handler, Ring& ring);
+
+	// Stamps the dequeue time on a batch of events, if latency tracing is compiled in
+	static void StampDequeued(std::span<QueueEvent> events);
+
+	// Sequence number of the last event enqueued, in any mode
+	std::uint64_t LastEnqueued() const;
+
+	// Backs off a producer while the ring is full
+	void BackOff(std::size_t& spins) const;
+
+	// Publishes the sequence number of the last event processed to any waiters
+	void CompleteEvent(std::uint64_t sequence);
+
+	// Idles the worker thread while the ring is empty, according to the wait strategy
+	void IdleWorker(std::size_t& spins, std::uint64_t consumed);
+	void SignalWorker();
+};
+
+template <typename Handler>
+	requires std::invocable<Handler&, std::span<const QueueEvent>>
+QueueManager::QueueManager(Handler handler, const QueueConfig& config)
+	: QueueManager(config)
+{
+	// Wait for worker thread handling events to start
+
+	std::promise<void> readyPromise;
+	std::future<void> readyFuture = readyPromise.get_future();
+
+	workerThread_ = std::thread([this, handler = std::move(handler), promise = std::move(readyPromise)]() mutable
+	{
+		promise.set_value();
+		HandleEvents(handler);
+	});
+
+	readyFuture.wait();
+	PinWorker();
+}
+
+template <typename Handler>
+void QueueManager::HandleEvents(Handler& handler)
+{
+	switch (config_.mode_)
+	{
+	case QueueMode::Spsc:
+		HandleRingEvents(handler, *ring_);
+		break;
+	case QueueMode::Mpsc:
+		HandleRingEvents(handler, *mpscRing_);
+		break;
+	default:
+		HandleLockedEvents(handler);
+		break;
+	}
+}
+
+template <typename Handler>
+void QueueManager::HandleLockedEvents(Handler& handler)
+{
+	std::vector<QueueEvent> batch;
+	batch.reserve(config_.batchSize_);
+
+	while (true)
+	{
+		// Fetch up to a batch of events from the queue
+
+		std::unique_lock<std::mutex> lock(queueMutex_);
+		condition_.wait(lock, [this]() { return stopQueueManager_ || !eventQueue_.empty(); });
+
+		if (stopQueueManager_ && eventQueue_.empty())
+			break;
+
+		batch.clear();
+		while (!eventQueue_.empty() && batch.size() < config_.batchSize_)
+		{
+			batch.push_back(eventQueue_.front());
+			eventQueue_.pop();
+		}
+		lock.unlock();
+		StampDequeued(batch);
+
+		// Events are handled by the OrderBook
+
+		handler(std::span<const QueueEvent>{ batch });
+		CompleteEvent(batch.back().sequence_);
+	}
+}
+
+template <typename Handler, typename Ring>
+void QueueManager::HandleRingEvents(Handler& handler, Ring& ring)
+{
+	std::vector<QueueEvent> batch(config_.batchSize_);
+	std::size_t spins = 0;
+
+	while (true)
+	{
+		if (const std::size_t popped = ring.TryPopBatch(batch); popped > 0)
+		{
+			StampDequeued(std::span<QueueEvent>{ batch.data(), popped });
+			handler(std::span<const QueueEvent>{ batch.data(), popped });
+			CompleteEvent(batch[popped - 1].sequence_);
+			spins = 0;
+			continue;
+		}
+
+		// Drain anything enqueued before the stop request
+
+		if (stopQueueManager_.load(std::memory_order_acquire))
+		{
+			if (ring.Empty()) break;
+			continue;
+		}
 
-	// Loop for worker threads to fetch and process QueueEvent objects
-	void HandleEvents();
-};
\ No newline at end of file
+		IdleWorker(spins, processed_.load(std::memory_order_acquire));
+	}
+}
@@ -0,0 +1,123 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include "../Util/Concurrency.h"
+
+// Bounded single-producer / single-consumer ring buffer. The head (consumer) and
+// tail (producer) indices live on separate cache lines, and each side caches the
+// other's index so it only touches the shared line when the ring looks full/empty
+
+template <typename T>
+class SpscRing
+{
+public:
+
+	explicit SpscRing(std::size_t capacity)
+		: slots_(std::bit_ceil(capacity < 2 ? std::size_t{ 2 } : capacity))
+		, mask_{ slots_.size() - 1 }
+	{
+	}
+
+	SpscRing(const SpscRing&) = delete;
+	SpscRing(SpscRing&&) = delete;
+	SpscRing& operator=(const SpscRing&) = delete;
+	SpscRing& operator=(SpscRing&&) = delete;
+
+	std::size_t Capacity() const { return slots_.size(); }
+
+	// Number of values pushed so far
+	std::uint64_t Claimed() const { return tail_.load(std::memory_order_acquire); }
+
+	bool Empty() const
+	{
+		return head_.load(std::memory_order_acquire) == tail_.load(std::memory_order_acquire);
+	}
+
+	// Producer side, returns false if the ring is full
+
+	bool TryPush(const T& value)
+	{
+		const std::size_t tail = tail_.load(std::memory_order_relaxed);
+		if (tail - cachedHead_ == slots_.size())
+		{
+			cachedHead_ = head_.load(std::memory_order_acquire);
+			if (tail - cachedHead_ == slots_.size()) return false;
+		}
+
+		slots_[tail & mask_] = value;
+		tail_.store(tail + 1, std::memory_order_release);
+		return true;
+	}
+
+	// Producer side, lets the writer fill up to count slots in place, each with its
+	// position in the ring, and publishes them at once. Returns the number written
+
+	template <typename Writer>
+	std::size_t TryPushBatch(std::size_t count, Writer&& writer)
+	{
+		const std::size_t tail = tail_.load(std::memory_order_relaxed);
+		if (slots_.size() - (tail - cachedHead_) < count)
+			cachedHead_ = head_.load(std::memory_order_acquire);
+
+		const std::size_t written = std::min(count, slots_.size() - (tail - cachedHead_));
+		for (std::size_t i = 0; i < written; ++i)
+			writer(slots_[(tail + i) & mask_], static_cast<std::uint64_t>(tail + i));
+
+		if (written > 0)
+			tail_.store(tail + written, std::memory_order_release);
+		return written;
+	}
+
+	// Consumer side, returns false if the ring is empty
+
+	bool TryPop(T& value)
+	{
+		const std::size_t head = head_.load(std::memory_order_relaxed);
+		if (head == cachedTail_)
+		{
+			cachedTail_ = tail_.load(std::memory_order_acquire);
+			if (head == cachedTail_) return false;
+		}
+
+		value = std::move(slots_[head & mask_]);
+		head_.store(head + 1, std::memory_order_release);
+		return true;
+	}
+
+	// Consumer side, pops up to values.size() values at once, returns the number popped
+
+	std::size_t TryPopBatch(std::span<T> values)
+	{
+		const std::size_t head = head_.load(std::memory_order_relaxed);
+		if (cachedTail_ - head < values.size())
+			cachedTail_ = tail_.load(std::memory_order_acquire);
+
+		const std::size_t popped = std::min(values.size(), cachedTail_ - head);
+		for (std::size_t i = 0; i < popped; ++i)
+			values[i] = std::move(slots_[(head + i) & mask_]);
+
+		if (popped > 0)
+			head_.store(head + popped, std::memory_order_release);
+		return popped;
+	}
+
+private:
+
+	// Consumer cache line
+	alignas(CacheLineSize) std::atomic<std::size_t> head_{ 0 };
+	std::size_t cachedTail_{ 0 };
+
+	// Producer cache line
+	alignas(CacheLineSize) std::atomic<std::size_t> tail_{ 0 };
+	std::size_t cachedHead_{ 0 };
+
+	alignas(CacheLineSize) std::vector<T> slots_;
+	std::size_t mask_;
+};
@@ -0,0 +1,53 @@
+#pragma once
+
+#include <cstdint>
+#include <string_view>
+#include <type_traits>
+
+#include "ExecutionReport.h"
+
+// State a queued request left its order in
+
+enum class CompletionStatus : std::uint8_t
+{
+	Rested,		// Accepted, the remainder rests on the book after any fills
+	Filled,		// Fully filled, nothing rests
+	Killed,		// The unfilled remainder of a fill-and-kill was cancelled
+	Cancelled,	// Cancelled on request
+	Rejected,	// Not applied, see the reason
+};
+
+inline std::string_view CompletionStatusToString(CompletionStatus status)
+{
+	switch (status)
+	{
+	case CompletionStatus::Rested: return "Rested";
+	case CompletionStatus::Filled: return "Filled";
+	case CompletionStatus::Killed: return "Killed";
+	case CompletionStatus::Cancelled: return "Cancelled";
+	case CompletionStatus::Rejected: return "Rejected";
+	default: return "N/A";
+	}
+}
+
+// Acknowledgement of a queued request, delivered to the completion ring of the
+// producer that submitted it once the book has handled the request
+
+struct Completion
+{
+	// Arrival sequence number of the request, as returned when it was queued
+	Ticket ticket_{ };
+	OrderId orderId_{ };
+
+	// Quantity the request executed over fills_ trades, and the quantity left
+	// resting on the book afterwards
+	Quantity filledQuantity_{ };
+	Quantity leavesQuantity_{ };
+	std::uint32_t fills_{ };
+
+	CompletionStatus status_{ };
+	RejectReason reason_{ RejectReason::None };
+};
+
+static_assert(std::is_trivially_copyable_v<Completion>);
+static_assert(sizeof(Completion) == 32);
@@ -0,0 +1,68 @@
+#pragma once
+
+#include <cstddef>
+#include <span>
+#include <thread>
+
+#include "Completion.h"
+#include "../Queue/SpscRing.h"
+#include "../Util/Concurrency.h"
+
+// Completions of the requests one producer queued, in the order they were handled.
+// The book's matching thread pushes and the producer polls, so a ring is registered
+// with a single book (see OrderBook::AddProducer). The matcher waits for room in a
+// full ring, size it to at least the requests a producer keeps in flight
+
+class CompletionRing
+{
+public:
+
+	explicit CompletionRing(std::size_t capacity = 1 << 12)
+		: ring_{ capacity }
+	{ }
+
+	CompletionRing(const CompletionRing&) = delete;
+	CompletionRing(CompletionRing&&) = delete;
+	CompletionRing& operator=(const CompletionRing&) = delete;
+	CompletionRing& operator=(CompletionRing&&) = delete;
+
+	// Matching thread side, spins while the producer makes room in a full ring
+
+	void Push(const Completion& completion)
+	{
+		while (!ring_.TryPush(completion))
+			CpuRelax();
+	}
+
+	// Producer side, takes up to completions.size() of the completions delivered so
+	// far without blocking, returns the number taken
+
+	std::size_t Poll(std::span<Completion> completions)
+	{
+		return ring_.TryPopBatch(completions);
+	}
+
+	// Producer side, blocks until at least one completion is delivered, then takes
+	// up to completions.size() of them
+
+	std::size_t Wait(std::span<Completion> completions)
+	{
+		std::size_t spins = 0;
+		std::size_t taken;
+
+		while ((taken = Poll(completions)) == 0 && !completions.empty())
+		{
+			if (++spins < SpinLimit) CpuRelax();
+			else std::this_thread::yield();
+		}
+
+		return taken;
+	}
+
+private:
+
+	// Polls spent spinning before a waiting producer starts yielding
+	static constexpr std::size_t SpinLimit = 1'000;
+
+	SpscRing<Completion> ring_;
+};
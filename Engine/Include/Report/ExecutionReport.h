@@ -0,0 +1,82 @@
+#pragma once
+
+#include <cstdint>
+#include <string_view>
+#include <type_traits>
+
+#include "../Orderbook/Using.h"
+#include "../Enum/Side.h"
+
+enum class ExecutionType : std::uint8_t
+{
+	Fill,
+	Cancel,
+	Reject,
+};
+
+enum class RejectReason : std::uint8_t
+{
+	None,
+	DuplicateOrderId,
+	OrderNotFound,
+	FillAndKillMiss,
+	FillOrKillMiss,
+	NoLiquidity,
+	OrderIdOutOfRange,
+};
+
+inline std::string_view ExecutionTypeToString(ExecutionType type)
+{
+	switch (type)
+	{
+	case ExecutionType::Fill: return "Fill";
+	case ExecutionType::Cancel: return "Cancel";
+	case ExecutionType::Reject: return "Reject";
+	default: return "N/A";
+	}
+}
+
+inline std::string_view RejectReasonToString(RejectReason reason)
+{
+	switch (reason)
+	{
+	case RejectReason::None: return "None";
+	case RejectReason::DuplicateOrderId: return "DuplicateOrderId";
+	case RejectReason::OrderNotFound: return "OrderNotFound";
+	case RejectReason::FillAndKillMiss: return "FillAndKillMiss";
+	case RejectReason::FillOrKillMiss: return "FillOrKillMiss";
+	case RejectReason::NoLiquidity: return "NoLiquidity";
+	case RejectReason::OrderIdOutOfRange: return "OrderIdOutOfRange";
+	default: return "N/A";
+	}
+}
+
+// Outcome of an order request for a single order, published by the OrderBook to its
+// ExecutionReportSink. A trade produces one fill report for each of its two orders
+
+struct ExecutionReport
+{
+	// Arrival sequence number of the request that produced the report
+	std::uint64_t sequence_{ };
+
+	OrderId orderId_{ };
+
+	// Order on the other side of a fill
+	OrderId counterpartyId_{ };
+
+	SymbolId symbolId_{ };
+	Price price_{ };
+
+	// Executed quantity for fills, cancelled quantity for cancels and requested
+	// quantity for rejects
+	Quantity quantity_{ };
+
+	// Quantity still open after a fill
+	Quantity leavesQuantity_{ };
+
+	ExecutionType type_{ };
+	RejectReason reason_{ RejectReason::None };
+	Side side_{ };
+};
+
+static_assert(std::is_trivially_copyable_v<ExecutionReport>);
@@ -0,0 +1,37 @@
+#pragma once
+
+#include <span>
+
+#include "ExecutionReport.h"
+#include "../Queue/DrainedRing.h"
+
+// Fills, cancels and rejects published by the books, handed to the report handler in
+// batches and in publication order (see DrainedRing)
+
+class ExecutionReportSink
+{
+public:
+
+	using ReportHandler = BatchHandler<ExecutionReport>::Handler;
+
+	explicit ExecutionReportSink(ReportHandler reportHandler, std::size_t capacity = 1 << 16);
+
+	// Hands any reports still in the ring to the handler before returning
+	~ExecutionReportSink() = default;
+
+	ExecutionReportSink(const ExecutionReportSink&) = delete;
+	ExecutionReportSink(ExecutionReportSink&&) = delete;
+	ExecutionReportSink& operator=(const ExecutionReportSink&) = delete;
+	ExecutionReportSink& operator=(ExecutionReportSink&&) = delete;
+
+	// Matching thread side, spins while the consumer makes room in a full ring
+	void Publish(const ExecutionReport& report) { ring_.Push(report); }
+
+	// Blocks until every report published before the call has been handled
+	void Flush() const { ring_.Flush(); }
+
+private:
+
+	// Drained by a consumer thread handing batches to the handler
+	DrainedRing<ExecutionReport, BatchHandler<ExecutionReport>> ring_;
+};
@@ -0,0 +1,74 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+#include "../Orderbook/Using.h"
+#include "../Enum/OrderType.h"
+
+// On-disk layout of a point-in-time copy of an OrderBook, written by TakeSnapshot and
+// mapped read-only by Recover. A header is followed by the bid levels from best to
+// worst, then the ask levels from best to worst, then the orders of every level in
+// the same order, each level's orders by time priority
+
+struct SnapshotHeader
+{
+	static constexpr std::uint64_t Magic = 0x5053414E'4B4F4F42; // "BOOKSNAP"
+	static constexpr std::uint32_t CurrentVersion = 1;
+
+	std::uint64_t magic_{ Magic };
+	std::uint32_t version_{ CurrentVersion };
+	SymbolId symbolId_{ };
+
+	// Arrival sequence number of the last request reflected in the snapshot, the
+	// journal is replayed from the record after it
+	std::uint64_t sequence_{ };
+
+	std::uint64_t bidLevels_{ };
+	std::uint64_t askLevels_{ };
+	std::uint64_t orders_{ };
+
+	std::uint8_t reserved_[16]{ };
+};
+
+struct SnapshotLevel
+{
+	Price price_{ };
+
+	// Aggregate remaining quantity and number of the orders resting at the level
+	Quantity quantity_{ };
+	std::uint32_t count_{ };
+};
+
+struct SnapshotOrder
+{
+	OrderId orderId_{ };
+	Quantity initialQuantity_{ };
+	Quantity remainingQuantity_{ };
+	OrderType orderType_{ };
+};
+
+static_assert(sizeof(SnapshotHeader) == 64);
+static_assert(std::is_trivially_copyable_v<SnapshotLevel> && sizeof(SnapshotLevel) == 12);
+static_assert(std::is_trivially_copyable_v<SnapshotOrder> && sizeof(SnapshotOrder) == 24);
+
+// Byte offsets of the sections of a snapshot, the orders are aligned for direct access
+
+inline std::size_t SnapshotLevelsOffset()
+{
+	return sizeof(SnapshotHeader);
+}
+
+inline std::size_t SnapshotOrdersOffset(const SnapshotHeader& header)
+{
+	const std::size_t levelsEnd = SnapshotLevelsOffset() +
+		static_cast<std::size_t>(header.bidLevels_ + header.askLevels_) * sizeof(SnapshotLevel);
+
+	return (levelsEnd + alignof(SnapshotOrder) - 1) / alignof(SnapshotOrder) * alignof(SnapshotOrder);
+}
+
+inline std::size_t SnapshotSize(const SnapshotHeader& header)
+{
+	return SnapshotOrdersOffset(header) + static_cast<std::size_t>(header.orders_) * sizeof(SnapshotOrder);
+}
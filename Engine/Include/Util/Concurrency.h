@@ -0,0 +1,24 @@
+#pragma once
+
+#include <cstddef>
+#include <thread>
+
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <intrin.h>
+#endif
+
+// Alignment used to keep independently written atomics on separate cache lines
+inline constexpr std::size_t CacheLineSize = 64;
+
+// Hint to the CPU that the calling thread is spinning on a shared location
+
+inline void CpuRelax()
+{
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+	_mm_pause();
+#elif defined(__x86_64__) || defined(__i386__)
+	__builtin_ia32_pause();
+#else
+	std::this_thread::yield();
+#endif
+}
@@ -0,0 +1,71 @@
+#pragma once
+
+#include <cstddef>
+#include <filesystem>
+#include <iterator>
+#include <optional>
+#include <string_view>
+
+#include "EventInformation.h"
+#include "MappedFile.h"
+#include "TestResult.h"
+
+// Streams the order requests of a text scenario or replay file, one per line as
+// "A <id> <type> <B|S> <price> <quantity>", "M <id> <B|S> <price> <quantity>" or
+// "C <id>", optionally ended by an "R <all> <bids> <asks>" result line. The file is
+// mapped rather than read and each line is parsed in place as the iteration reaches
+// it, so files of any size are parsed without allocating. Lines of other kinds are
+// skipped, malformed requests throw logic_error
+
+class EventFileParser
+{
+public:
+
+	explicit EventFileParser(const std::filesystem::path& path);
+
+	class Iterator
+	{
+	public:
+
+		using iterator_category = std::input_iterator_tag;
+		using value_type = EventInformation;
+		using difference_type = std::ptrdiff_t;
+		using pointer = const EventInformation*;
+		using reference = const EventInformation&;
+
+		Iterator() = default;
+
+		reference operator*() const { return event_; }
+		pointer operator->() const { return &event_; }
+
+		Iterator& operator++() { Advance(); return *this; }
+		void operator++(int) { Advance(); }
+
+		bool operator==(std::default_sentinel_t) const { return next_ == nullptr; }
+
+	private:
+
+		friend class EventFileParser;
+
+		explicit Iterator(std::string_view text);
+
+		// Parses the next request into event_, or ends the iteration
+		void Advance();
+
+		const char* next_{ nullptr };
+		const char* end_{ nullptr };
+		EventInformation event_{ };
+	};
+
+	Iterator begin() const { return Iterator{ Text() }; }
+	std::default_sentinel_t end() const { return { }; }
+
+	// Expected book sizes of a scenario file, if its last line is a result line
+	std::optional<TestResult> Result() const;
+
+	std::string_view Text() const;
+
+private:
+
+	MappedFile file_;
+};
@@ -4,6 +4,7 @@
 #include "../OrderBook/Order.h"
 #include "../OrderBook/Using.h"
 #include "../Queue/EventType.h"
+#include "../Queue/QueueEvent.h"
 
 struct EventInformation
 {
@@ -15,4 +16,21 @@ struct EventInformation
     Quantity quantity_;
 };
 
-using EventInformations = std::vector<EventInformation>;
\ No newline at end of file
+using EventInformations = std::vector<EventInformation>;
+
+// Converts parsed or generated order information to an event for SubmitBatch
+
+inline QueueEvent ToQueueEvent(const EventInformation& info)
+{
+    switch (info.eventType_)
+    {
+        case EventType::AddOrder:
+            return QueueEvent{ AddOrderPayload{ info.orderId_, info.orderType_, info.side_, info.price_, info.quantity_ } };
+        case EventType::ModifyOrder:
+            return QueueEvent{ ModifyOrderPayload{ info.orderId_, info.side_, info.price_, info.quantity_ } };
+        case EventType::CancelOrder:
+            return QueueEvent{ CancelOrderPayload{ info.orderId_ } };
+        default:
+            throw std::logic_error("Unsupported event.");
+    }
+}
\ No newline at end of file
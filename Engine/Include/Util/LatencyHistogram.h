@@ -0,0 +1,104 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cstdint>
+
+// HDR-style histogram of latencies in nanoseconds. Values below 128 get a bucket
+// each, above that every power of two is split into 64 linear sub-buckets, so any
+// recorded value is reported within 1.6% of itself, up to about 18 minutes. A
+// single thread records with relaxed loads and stores and never allocates, any
+// other thread may read percentiles while it does
+
+class LatencyHistogram
+{
+public:
+
+	LatencyHistogram() = default;
+
+	LatencyHistogram(const LatencyHistogram&) = delete;
+	LatencyHistogram& operator=(const LatencyHistogram&) = delete;
+
+	// Writer side, must only be called from one thread at a time
+
+	void Record(std::uint64_t nanoseconds)
+	{
+		auto& count = counts_[IndexOf(nanoseconds)];
+		count.store(count.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+		total_.store(total_.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+
+		if (nanoseconds > max_.load(std::memory_order_relaxed))
+			max_.store(nanoseconds, std::memory_order_relaxed);
+	}
+
+	void Reset()
+	{
+		for (auto& count : counts_)
+			count.store(0, std::memory_order_relaxed);
+
+		total_.store(0, std::memory_order_relaxed);
+		max_.store(0, std::memory_order_relaxed);
+	}
+
+	// Reader side
+
+	std::uint64_t Count() const { return total_.load(std::memory_order_relaxed); }
+	std::uint64_t Max() const { return max_.load(std::memory_order_relaxed); }
+
+	// Smallest recorded value such that the given percentage of values are at or
+	// below it, reported as the highest value of its bucket
+
+	std::uint64_t ValueAtPercentile(double percentile) const
+	{
+		const std::uint64_t total = Count();
+		if (total == 0) return 0;
+
+		const auto target = std::max<std::uint64_t>(1,
+			static_cast<std::uint64_t>(percentile / 100.0 * static_cast<double>(total) + 0.5));
+
+		std::uint64_t seen = 0;
+		for (std::size_t index = 0; index < BucketCount; ++index)
+		{
+			seen += counts_[index].load(std::memory_order_relaxed);
+			if (seen >= target)
+				return std::min(HighestValueOf(index), Max());
+		}
+		return Max();
+	}
+
+private:
+
+	static constexpr unsigned SubBucketBits = 6;
+	static constexpr std::size_t SubBucketCount = std::size_t{ 1 } << SubBucketBits;
+
+	// Values of up to 40 bits are told apart, larger ones share the last bucket
+	static constexpr unsigned ValueBits = 40;
+	static constexpr std::size_t BucketCount = (ValueBits - SubBucketBits + 1) * SubBucketCount;
+
+	static std::size_t IndexOf(std::uint64_t value)
+	{
+		if (value < 2 * SubBucketCount) return static_cast<std::size_t>(value);
+
+		// Keep the top SubBucketBits + 1 bits of the value, i.e. a sub-bucket in
+		// [SubBucketCount, 2 * SubBucketCount) at a given shift
+
+		const unsigned shift = static_cast<unsigned>(std::bit_width(value)) - SubBucketBits - 1;
+		const auto index = (shift + 1) * SubBucketCount + static_cast<std::size_t>(value >> shift) - SubBucketCount;
+		return std::min(index, BucketCount - 1);
+	}
+
+	static std::uint64_t HighestValueOf(std::size_t index)
+	{
+		if (index < 2 * SubBucketCount) return index;
+
+		const auto shift = static_cast<unsigned>(index / SubBucketCount - 1);
+		const auto subBucket = static_cast<std::uint64_t>(index % SubBucketCount + SubBucketCount);
+		return ((subBucket + 1) << shift) - 1;
+	}
+
+	std::array<std::atomic<std::uint64_t>, BucketCount> counts_{ };
+	std::atomic<std::uint64_t> total_{ 0 };
+	std::atomic<std::uint64_t> max_{ 0 };
+};
@@ -0,0 +1,132 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <format>
+#include <ostream>
+#include <string_view>
+
+#include "Concurrency.h"
+#include "LatencyHistogram.h"
+
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <intrin.h>
+#elif defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+// Request latency tracing is compiled in by defining ORDERBOOK_LATENCY_TRACE for
+// every translation unit, as it adds timestamps to QueueEvent. Without it the
+// queue and the book take no timestamps and keep no histograms
+
+// Reads the CPU timestamp counter, or a steady clock in nanoseconds where there is
+// no such counter
+
+inline std::uint64_t ReadTimestamp()
+{
+#if (defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))) || defined(__x86_64__) || defined(__i386__)
+	return __rdtsc();
+#else
+	return static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+		std::chrono::steady_clock::now().time_since_epoch()).count());
+#endif
+}
+
+// Nanoseconds per ReadTimestamp tick, measured once against the steady clock over
+// a few milliseconds
+
+inline double NanosecondsPerTimestamp()
+{
+	static const double ratio = []()
+		{
+			using Clock = std::chrono::steady_clock;
+
+			const auto clockStart = Clock::now();
+			const auto timestampStart = ReadTimestamp();
+			while (Clock::now() - clockStart < std::chrono::milliseconds{ 10 })
+				CpuRelax();
+
+			const auto elapsed = std::chrono::duration<double, std::nano>(Clock::now() - clockStart).count();
+			const auto ticks = ReadTimestamp() - timestampStart;
+			return ticks > 0 ? elapsed / static_cast<double>(ticks) : 1.0;
+		}();
+
+	return ratio;
+}
+
+// Ticks from one ReadTimestamp value to a later one, zero if the counters of the
+// cores which took them are slightly out of step
+
+inline std::uint64_t TimestampsBetween(std::uint64_t from, std::uint64_t to)
+{
+	return to > from ? to - from : 0;
+}
+
+// Stages a queued request goes through, from AddOrderToQueue to its trades
+
+enum class LatencyStage : std::uint8_t
+{
+	QueueWait,	// Enqueue to dequeue by the worker thread
+	Match,		// Handling by the book, logging excluded
+	Logging,	// Journal or FileLogger writes made while handling
+	EndToEnd,	// Enqueue to the book returning from the request
+};
+
+inline constexpr std::size_t LatencyStageCount = 4;
+
+inline std::string_view LatencyStageToString(LatencyStage stage)
+{
+	switch (stage)
+	{
+	case LatencyStage::QueueWait: return "QueueWait";
+	case LatencyStage::Match: return "Match";
+	case LatencyStage::Logging: return "Logging";
+	case LatencyStage::EndToEnd: return "EndToEnd";
+	default: return "N/A";
+	}
+}
+
+// Latency histogram per stage, recorded by the thread handling the requests. Any
+// other thread may read or dump it at any time, e.g. periodically from a timer
+
+class LatencyTrace
+{
+public:
+
+	LatencyTrace()
+		: nanosecondsPerTimestamp_{ NanosecondsPerTimestamp() }
+	{ }
+
+	// Records the time between two ReadTimestamp values
+	void Record(LatencyStage stage, std::uint64_t ticks)
+	{
+		histograms_[static_cast<std::size_t>(stage)].Record(
+			static_cast<std::uint64_t>(static_cast<double>(ticks) * nanosecondsPerTimestamp_));
+	}
+
+	const LatencyHistogram& Histogram(LatencyStage stage) const
+	{
+		return histograms_[static_cast<std::size_t>(stage)];
+	}
+
+	// Writes a line of nanosecond percentiles per stage
+	void Dump(std::ostream& stream) const
+	{
+		for (std::size_t index = 0; index < LatencyStageCount; ++index)
+		{
+			const auto stage = static_cast<LatencyStage>(index);
+			const auto& histogram = Histogram(stage);
+
+			stream << std::format("{:<10} count {:>10} p50 {:>8} p99 {:>8} p99.9 {:>8} max {:>10}\n",
+				LatencyStageToString(stage), histogram.Count(), histogram.ValueAtPercentile(50.0),
+				histogram.ValueAtPercentile(99.0), histogram.ValueAtPercentile(99.9), histogram.Max());
+		}
+	}
+
+private:
+
+	double nanosecondsPerTimestamp_;
+	std::array<LatencyHistogram, LatencyStageCount> histograms_;
+};
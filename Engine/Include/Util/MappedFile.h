@@ -0,0 +1,54 @@
+#pragma once
+
+#include <cstddef>
+#include <filesystem>
+
+// A file mapped into memory, either an existing file mapped read-only or a new file
+// preallocated to a fixed size and mapped read-write. Failures throw runtime_error
+
+class MappedFile
+{
+public:
+
+	MappedFile() = default;
+
+	// Maps the whole of an existing file read-only
+	explicit MappedFile(const std::filesystem::path& path);
+
+	// Creates or truncates the file, preallocates it to size bytes of zeros and maps
+	// it read-write
+	MappedFile(const std::filesystem::path& path, std::size_t size);
+
+	// Unmaps the file, dirty pages still reach the file through the page cache
+	~MappedFile();
+
+	MappedFile(const MappedFile&) = delete;
+	MappedFile& operator=(const MappedFile&) = delete;
+	MappedFile(MappedFile&& other) noexcept;
+	MappedFile& operator=(MappedFile&& other) noexcept;
+
+	std::byte* Data() { return data_; }
+	const std::byte* Data() const { return data_; }
+	std::size_t Size() const { return size_; }
+	bool IsOpen() const { return data_ != nullptr; }
+
+	// Writes dirty pages of a read-write mapping back to the file
+	void Flush();
+
+	void Close();
+
+private:
+
+	std::byte* data_{ nullptr };
+	std::size_t size_{ 0 };
+	bool writable_{ false };
+
+#if defined(_WIN32)
+	void* file_{ nullptr };
+	void* mapping_{ nullptr };
+#else
+	int file_{ -1 };
+#endif
+
+	void Swap(MappedFile& other) noexcept;
+};
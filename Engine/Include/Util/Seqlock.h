@@ -0,0 +1,81 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+#include "Concurrency.h"
+
+// Single-writer sequence lock around a trivially copyable value. The writer never
+// waits, readers copy the value without writing to shared memory and retry if a
+// write overlapped their copy. The value is stored as atomic words so that the
+// racing copies are well defined
+
+template <typename T>
+class Seqlock
+{
+	static_assert(std::is_trivially_copyable_v<T>);
+
+public:
+
+	Seqlock()
+	{
+		Store(T{ });
+	}
+
+	// Writer side, must only be called from one thread at a time
+
+	void Store(const T& value)
+	{
+		Words words{ };
+		std::memcpy(words.data(), &value, sizeof(T));
+
+		const auto sequence = sequence_.load(std::memory_order_relaxed);
+		sequence_.store(sequence + 1, std::memory_order_relaxed);
+		std::atomic_thread_fence(std::memory_order_release);
+
+		for (std::size_t i = 0; i < WordCount; ++i)
+			words_[i].store(words[i], std::memory_order_relaxed);
+
+		sequence_.store(sequence + 2, std::memory_order_release);
+	}
+
+	// Reader side, safe from any number of threads
+
+	T Load() const
+	{
+		Words words{ };
+
+		while (true)
+		{
+			const auto before = sequence_.load(std::memory_order_acquire);
+			if (before & 1)
+			{
+				CpuRelax();
+				continue;
+			}
+
+			for (std::size_t i = 0; i < WordCount; ++i)
+				words[i] = words_[i].load(std::memory_order_relaxed);
+
+			std::atomic_thread_fence(std::memory_order_acquire);
+			if (sequence_.load(std::memory_order_relaxed) == before)
+				break;
+		}
+
+		T value;
+		std::memcpy(static_cast<void*>(&value), words.data(), sizeof(T));
+		return value;
+	}
+
+private:
+
+	static constexpr std::size_t WordCount = (sizeof(T) + sizeof(std::uint64_t) - 1) / sizeof(std::uint64_t);
+	using Words = std::array<std::uint64_t, WordCount>;
+
+	// Odd while a write is in progress
+	alignas(CacheLineSize) std::atomic<std::uint64_t> sequence_{ 0 };
+	std::array<std::atomic<std::uint64_t>, WordCount> words_{ };
+};
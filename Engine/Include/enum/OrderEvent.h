@@ -5,4 +5,5 @@ enum class OrderEvent
 	AddOrder,
 	CancelOrder,
 	MatchOrder,
+	ReduceOrder,
 };
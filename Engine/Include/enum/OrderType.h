@@ -1,9 +1,10 @@
 #pragma once
 
+#include <cstdint>
 #include <string>
 #include <string_view>
 
-enum class OrderType
+enum class OrderType : std::uint8_t
 {
 	GoodTillCancel,
 	Market,
@@ -1,11 +1,17 @@
 #pragma once
 
-enum class Side
+#include <cstdint>
+#include <string_view>
+
+enum class Side : std::uint8_t
 {
 	Buy,
 	Sell,
 };
 
+template <Side S>
+inline constexpr Side OppositeSide = (S == Side::Buy) ? Side::Sell : Side::Buy;
+
 inline std::string_view SideToString(Side side)
 {
 	switch (side)
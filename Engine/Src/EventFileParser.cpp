@@ -0,0 +1,193 @@
+#include "../Include/Util/EventFileParser.h"
+
+#include <charconv>
+#include <cstring>
+#include <format>
+#include <stdexcept>
+
+namespace
+{
+	[[noreturn]] void ThrowMalformed(std::string_view line)
+	{
+		throw std::logic_error(std::format("Malformed request \"{}\".", line));
+	}
+
+	// Reads the space separated fields of a line left to right, in place. A field
+	// followed by anything but a delimiter makes the line malformed
+
+	class FieldReader
+	{
+	public:
+
+		explicit FieldReader(std::string_view line)
+			: line_{ line }
+			, next_{ line.data() + 1 }
+			, end_{ line.data() + line.size() }
+		{ }
+
+		template <typename T>
+		T Number()
+		{
+			SkipSpaces();
+
+			T value{ };
+			const auto [end, error] = std::from_chars(next_, end_, value);
+			if (error != std::errc{ } || value < T{ } || !IsDelimiter(end)) ThrowMalformed(line_);
+
+			next_ = end;
+			return value;
+		}
+
+		std::string_view Word()
+		{
+			SkipSpaces();
+
+			const auto* end = next_;
+			while (!IsDelimiter(end)) ++end;
+			if (end == next_) ThrowMalformed(line_);
+
+			const std::string_view word{ next_, static_cast<std::size_t>(end - next_) };
+			next_ = end;
+			return word;
+		}
+
+		OrderType OrderTypeField()
+		{
+			// The names differ in length, so only one comparison is made
+
+			const auto word = Word();
+			switch (word.size())
+			{
+			case 14: if (word == "GoodTillCancel") return OrderType::GoodTillCancel; break;
+			case 11: if (word == "FillAndKill") return OrderType::FillAndKill; break;
+			case 10: if (word == "FillOrKill") return OrderType::FillOrKill; break;
+			case 6: if (word == "Market") return OrderType::Market; break;
+			default: break;
+			}
+			ThrowMalformed(line_);
+		}
+
+		Side SideField()
+		{
+			const auto word = Word();
+			if (word.size() == 1 && word.front() == 'B') return Side::Buy;
+			if (word.size() == 1 && word.front() == 'S') return Side::Sell;
+			ThrowMalformed(line_);
+		}
+
+	private:
+
+		// Fields end at a space, a carriage return or the end of the line
+
+		bool IsDelimiter(const char* at) const
+		{
+			return at == end_ || *at == ' ' || *at == '\r';
+		}
+
+		void SkipSpaces()
+		{
+			while (next_ != end_ && *next_ == ' ') ++next_;
+		}
+
+		std::string_view line_;
+		const char* next_;
+		const char* end_;
+	};
+
+	bool IsBlank(const char* begin, const char* end)
+	{
+		for (; begin != end; ++begin)
+			if (*begin != ' ' && *begin != '\r' && *begin != '\n') return false;
+
+		return true;
+	}
+}
+
+EventFileParser::EventFileParser(const std::filesystem::path& path)
+	: file_{ path }
+{ }
+
+std::string_view EventFileParser::Text() const
+{
+	return { reinterpret_cast<const char*>(file_.Data()), file_.Size() };
+}
+
+std::optional<TestResult> EventFileParser::Result() const
+{
+	const auto text = Text();
+
+	// Only the last non-blank line is looked at
+
+	std::size_t end = text.size();
+	while (end > 0 && IsBlank(text.data() + end - 1, text.data() + end)) --end;
+	if (end == 0) return std::nullopt;
+
+	const std::size_t newline = text.find_last_of('\n', end - 1);
+	const std::size_t begin = (newline == std::string_view::npos) ? 0 : newline + 1;
+	const auto line = text.substr(begin, end - begin);
+
+	if (line.front() != 'R') return std::nullopt;
+
+	FieldReader fields{ line };
+	TestResult result;
+	result.allCount_ = fields.Number<std::size_t>();
+	result.bidCount_ = fields.Number<std::size_t>();
+	result.askCount_ = fields.Number<std::size_t>();
+	return result;
+}
+
+EventFileParser::Iterator::Iterator(std::string_view text)
+	: next_{ text.data() }
+	, end_{ text.data() + text.size() }
+{
+	Advance();
+}
+
+void EventFileParser::Iterator::Advance()
+{
+	while (next_ != end_)
+	{
+		const auto* newline = static_cast<const char*>(std::memchr(next_, '\n', static_cast<std::size_t>(end_ - next_)));
+		const auto* lineEnd = newline ? newline : end_;
+
+		std::string_view line{ next_, static_cast<std::size_t>(lineEnd - next_) };
+		next_ = newline ? newline + 1 : end_;
+
+		if (!line.empty() && line.back() == '\r') line.remove_suffix(1);
+		if (line.empty()) continue;
+
+		FieldReader fields{ line };
+
+		switch (line.front())
+		{
+		case 'A':
+			event_.eventType_ = EventType::AddOrder;
+			event_.orderId_ = fields.Number<OrderId>();
+			event_.orderType_ = fields.OrderTypeField();
+			event_.side_ = fields.SideField();
+			event_.price_ = fields.Number<Price>();
+			event_.quantity_ = fields.Number<Quantity>();
+			return;
+		case 'M':
+			event_.eventType_ = EventType::ModifyOrder;
+			event_.orderId_ = fields.Number<OrderId>();
+			event_.side_ = fields.SideField();
+			event_.price_ = fields.Number<Price>();
+			event_.quantity_ = fields.Number<Quantity>();
+			return;
+		case 'C':
+			event_.eventType_ = EventType::CancelOrder;
+			event_.orderId_ = fields.Number<OrderId>();
+			return;
+		case 'R':
+			if (!IsBlank(next_, end_))
+				throw std::logic_error("Result should only be specified at the end.");
+			next_ = end_;
+			break;
+		default:
+			break;
+		}
+	}
+
+	next_ = nullptr;
+}
@@ -0,0 +1,131 @@
+#include "../Include/Exchange/Exchange.h"
+
+#include <algorithm>
+
+Exchange::Exchange(const ExchangeConfig& config)
+	: config_{ config }
+	, shardSymbols_(std::max<std::size_t>(config.matchingThreads_, 1), 0)
+{
+	for (std::size_t shard = 0; shard < shardSymbols_.size(); ++shard)
+	{
+		QueueConfig queueConfig = config_.book_.queue_;
+		queueConfig.core_ = shard < config_.cores_.size() ? config_.cores_[shard] : -1;
+
+		shards_.push_back(std::make_unique<QueueManager>(
+			[this](std::span<const QueueEvent> events) { HandleShardEvents(events); }, queueConfig));
+	}
+}
+
+Exchange::~Exchange()
+{
+	// Stop the matching threads first, draining whatever they still hold
+
+	shards_.clear();
+}
+
+OrderBook& Exchange::AddSymbol(SymbolId symbol)
+{
+	if (symbol < books_.size() && books_[symbol])
+		throw std::logic_error(std::format("Symbol {} already has a book.", symbol));
+
+	if (symbol >= books_.size())
+	{
+		books_.resize(symbol + 1);
+		shardOf_.resize(symbol + 1);
+	}
+
+	const auto shard = static_cast<std::size_t>(
+		std::min_element(shardSymbols_.begin(), shardSymbols_.end()) - shardSymbols_.begin());
+
+	OrderBookConfig bookConfig = config_.book_;
+	bookConfig.symbolId_ = symbol;
+
+	books_[symbol] = std::make_unique<OrderBook>(bookConfig, *shards_[shard]);
+	shardOf_[symbol] = shard;
+	++shardSymbols_[shard];
+	++symbolCount_;
+
+	return *books_[symbol];
+}
+
+void Exchange::AddOrderToQueue(SymbolId symbol, OrderId id, OrderType type, Side side, Price price, Quantity quantity)
+{
+	SubmitEvent(QueueEvent{ AddOrderPayload{ id, type, side, price, quantity, symbol } });
+}
+
+void Exchange::ModifyOrderToQueue(SymbolId symbol, OrderId id, Side side, Price price, Quantity quantity)
+{
+	SubmitEvent(QueueEvent{ ModifyOrderPayload{ id, side, price, quantity, symbol } });
+}
+
+void Exchange::CancelOrderToQueue(SymbolId symbol, OrderId id)
+{
+	SubmitEvent(QueueEvent{ CancelOrderPayload{ id, symbol } });
+}
+
+void Exchange::SubmitEvent(const QueueEvent& event)
+{
+	shards_[ShardOf(event.symbolId_)]->EnqueueEvent(event);
+}
+
+void Exchange::SubmitBatch(std::span<const QueueEvent> events)
+{
+	while (!events.empty())
+	{
+		const std::size_t shard = ShardOf(events.front().symbolId_);
+
+		std::size_t run = 1;
+		while (run < events.size() && ShardOf(events[run].symbolId_) == shard)
+			++run;
+
+		shards_[shard]->EnqueueEvents(events.first(run));
+		events = events.subspan(run);
+	}
+}
+
+void Exchange::WaitForAllEvents() const
+{
+	for (const auto& shard : shards_)
+		shard->WaitForAllEvents();
+}
+
+OrderBook& Exchange::GetBook(SymbolId symbol) const
+{
+	// Throws if the symbol has no book
+
+	ShardOf(symbol);
+	return *books_[symbol];
+}
+
+std::size_t Exchange::SymbolCount() const
+{
+	return symbolCount_;
+}
+
+std::size_t Exchange::MatchingThreadCount() const
+{
+	return shards_.size();
+}
+
+std::size_t Exchange::ShardOf(SymbolId symbol) const
+{
+	if (symbol >= books_.size() || !books_[symbol])
+		throw std::out_of_range(std::format("Symbol {} has no book.", symbol));
+
+	return shardOf_[symbol];
+}
+
+void Exchange::HandleShardEvents(std::span<const QueueEvent> events)
+{
+	while (!events.empty())
+	{
+		const SymbolId symbol = events.front().symbolId_;
+
+		std::size_t run = 1;
+		while (run < events.size() && events[run].symbolId_ == symbol)
+			++run;
+
+		books_[symbol]->HandleEvents(events.first(run));
+		events = events.subspan(run);
+	}
+}
@@ -0,0 +1,5 @@
+#include "../Include/Report/ExecutionReportSink.h"
+
+ExecutionReportSink::ExecutionReportSink(ReportHandler reportHandler, std::size_t capacity)
+	: ring_{ BatchHandler<ExecutionReport>{ std::move(reportHandler) }, capacity }
+{ }
@@ -2,8 +2,21 @@
 
 std::shared_ptr<spdlog::logger> FileLogger::logger_ = nullptr;
 
+namespace
+{
+	// Every OrderBook initializes and cleans up the logger, so it is shared between
+	// the live books and only torn down with the last of them
+
+	std::mutex usersMutex;
+	std::size_t users = 0;
+}
+
 void FileLogger::Init(const std::string_view path)
 {
+	std::scoped_lock lock{ usersMutex };
+	if (users++ > 0)
+		return;
+
 	static std::once_flag flag;
 	std::call_once(flag, []() { spdlog::init_thread_pool(800'000, 4); });
 
@@ -33,6 +46,10 @@ void FileLogger::Init(const std::string_view path)
 
 void FileLogger::Cleanup()
 {
+	std::scoped_lock lock{ usersMutex };
+	if (users == 0 || --users > 0)
+		return;
+
 	if (logger_)
 	{
 		spdlog::drop("FileLogger");
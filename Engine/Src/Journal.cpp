@@ -0,0 +1,96 @@
+#include "../Include/Journal/Journal.h"
+
+#include <algorithm>
+#include <format>
+#include <span>
+
+Journal::Journal(std::filesystem::path path, std::size_t segmentRecords, std::size_t capacity)
+	: path_{ std::move(path) }
+	, segmentRecords_{ std::max<std::size_t>(segmentRecords, 1) }
+	, segmentIndex_{ SegmentCount(path_) }
+	, segment_{ CreateFirstSegment() }
+	, ring_{ SegmentWriter{ this }, capacity }
+{ }
+
+Journal::~Journal()
+{
+	ring_.Stop();
+	segment_.Flush();
+}
+
+std::filesystem::path Journal::SegmentPath(const std::filesystem::path& path, std::size_t segment)
+{
+	return std::format("{}.{:06}", path.string(), segment);
+}
+
+void Journal::Remove(const std::filesystem::path& path)
+{
+	for (std::size_t segment = 0; std::filesystem::remove(SegmentPath(path, segment)); ++segment) {}
+}
+
+std::size_t Journal::SegmentCount(const std::filesystem::path& path)
+{
+	std::size_t segment = 0;
+	while (std::filesystem::exists(SegmentPath(path, segment))) ++segment;
+	return segment;
+}
+
+JournalSegmentHeader& Journal::Header()
+{
+	return *reinterpret_cast<JournalSegmentHeader*>(segment_.Data());
+}
+
+JournalRecord* Journal::Records()
+{
+	return reinterpret_cast<JournalRecord*>(segment_.Data() + sizeof(JournalSegmentHeader));
+}
+
+MappedFile Journal::CreateFirstSegment()
+{
+	// Opened here rather than by the writer thread so that a bad path throws to the
+	// caller
+
+	if (path_.has_parent_path())
+		std::filesystem::create_directories(path_.parent_path());
+
+	// The segments of an earlier journal are left as they are, they may still hold
+	// the tail a restarted book recovers from
+
+	return MapSegment(segmentIndex_);
+}
+
+MappedFile Journal::MapSegment(std::size_t index)
+{
+	MappedFile segment{ SegmentPath(path_, index),
+		sizeof(JournalSegmentHeader) + segmentRecords_ * sizeof(JournalRecord) };
+
+	*reinterpret_cast<JournalSegmentHeader*>(segment.Data()) = JournalSegmentHeader{ .capacity_ = segmentRecords_ };
+	return segment;
+}
+
+void Journal::OpenSegment(std::size_t index)
+{
+	segment_.Flush();
+	segment_ = MapSegment(index);
+	segmentIndex_ = index;
+}
+
+std::size_t Journal::WriteRecords(MpscRing<JournalRecord>& ring)
+{
+	// Pop straight into the mapped segment, rolling over once it is full and more
+	// records are waiting
+
+	if (Header().recordCount_ == Header().capacity_)
+	{
+		if (ring.Empty()) return 0;
+		OpenSegment(segmentIndex_ + 1);
+	}
+
+	auto& header = Header();
+	const auto room = std::min<std::size_t>(header.capacity_ - header.recordCount_, DrainBatch);
+	const std::span<JournalRecord> destination{ Records() + header.recordCount_, room };
+
+	const std::size_t popped = ring.TryPopBatch(destination);
+	header.recordCount_ += popped;
+	return popped;
+}
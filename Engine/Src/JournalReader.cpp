@@ -0,0 +1,53 @@
+#include "../Include/Journal/JournalReader.h"
+
+#include <format>
+#include <stdexcept>
+
+JournalReader::JournalReader(const std::filesystem::path& path)
+{
+	for (std::size_t segment = 0; std::filesystem::exists(Journal::SegmentPath(path, segment)); ++segment)
+	{
+		const auto segmentPath = Journal::SegmentPath(path, segment);
+		MappedFile file{ segmentPath };
+
+		if (file.Size() < sizeof(JournalSegmentHeader))
+			throw std::runtime_error(std::format("Journal segment {} is truncated.", segmentPath.string()));
+
+		const auto& header = *reinterpret_cast<const JournalSegmentHeader*>(file.Data());
+
+		if (header.magic_ != JournalSegmentHeader::Magic ||
+			header.version_ != JournalSegmentHeader::CurrentVersion ||
+			header.recordSize_ != sizeof(JournalRecord))
+			throw std::runtime_error(std::format("{} is not a version {} journal segment.",
+				segmentPath.string(), JournalSegmentHeader::CurrentVersion));
+
+		if (header.recordCount_ > header.capacity_ ||
+			sizeof(JournalSegmentHeader) + header.capacity_ * sizeof(JournalRecord) > file.Size())
+			throw std::runtime_error(std::format("Journal segment {} is truncated.", segmentPath.string()));
+
+		segments_.push_back(std::move(file));
+	}
+}
+
+std::size_t JournalReader::SegmentCount() const
+{
+	return segments_.size();
+}
+
+std::span<const JournalRecord> JournalReader::GetSegment(std::size_t segment) const
+{
+	const auto* data = segments_.at(segment).Data();
+	const auto& header = *reinterpret_cast<const JournalSegmentHeader*>(data);
+
+	return { reinterpret_cast<const JournalRecord*>(data + sizeof(JournalSegmentHeader)),
+		static_cast<std::size_t>(header.recordCount_) };
+}
+
+std::size_t JournalReader::Size() const
+{
+	std::size_t size = 0;
+	for (std::size_t segment = 0; segment < SegmentCount(); ++segment)
+		size += GetSegment(segment).size();
+
+	return size;
+}
@@ -0,0 +1,193 @@
+#include "../Include/Util/MappedFile.h"
+
+#include <format>
+#include <stdexcept>
+#include <utility>
+
+#if defined(_WIN32)
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace
+{
+	[[noreturn]] void ThrowMappingError(const std::filesystem::path& path, std::string_view what)
+	{
+#if defined(_WIN32)
+		const auto error = static_cast<int>(GetLastError());
+#else
+		const auto error = errno;
+#endif
+		throw std::runtime_error(std::format("Cannot {} {} (error {}).", what, path.string(), error));
+	}
+}
+
+#if defined(_WIN32)
+
+MappedFile::MappedFile(const std::filesystem::path& path)
+{
+	HANDLE file = CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE,
+		nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+	if (file == INVALID_HANDLE_VALUE) ThrowMappingError(path, "open");
+	file_ = file;
+
+	LARGE_INTEGER size{ };
+	if (!GetFileSizeEx(file, &size)) { Close(); ThrowMappingError(path, "size"); }
+	size_ = static_cast<std::size_t>(size.QuadPart);
+
+	// Empty files cannot be mapped, they are left open with no data
+
+	if (size_ == 0) return;
+
+	mapping_ = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+	if (!mapping_) { Close(); ThrowMappingError(path, "map"); }
+
+	data_ = static_cast<std::byte*>(MapViewOfFile(mapping_, FILE_MAP_READ, 0, 0, 0));
+	if (!data_) { Close(); ThrowMappingError(path, "map"); }
+}
+
+MappedFile::MappedFile(const std::filesystem::path& path, std::size_t size)
+	: size_{ size }
+	, writable_{ true }
+{
+	HANDLE file = CreateFileW(path.c_str(), GENERIC_READ | GENERIC_WRITE, FILE_SHARE_READ,
+		nullptr, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+	if (file == INVALID_HANDLE_VALUE) ThrowMappingError(path, "create");
+	file_ = file;
+
+	// Mapping a section larger than the file extends the file to the section size
+
+	LARGE_INTEGER mappingSize{ };
+	mappingSize.QuadPart = static_cast<LONGLONG>(size);
+
+	mapping_ = CreateFileMappingW(file, nullptr, PAGE_READWRITE,
+		static_cast<DWORD>(mappingSize.HighPart), mappingSize.LowPart, nullptr);
+	if (!mapping_) { Close(); ThrowMappingError(path, "preallocate"); }
+
+	data_ = static_cast<std::byte*>(MapViewOfFile(mapping_, FILE_MAP_WRITE, 0, 0, size));
+	if (!data_) { Close(); ThrowMappingError(path, "map"); }
+}
+
+void MappedFile::Flush()
+{
+	if (data_ && writable_) FlushViewOfFile(data_, size_);
+}
+
+void MappedFile::Close()
+{
+	if (data_) UnmapViewOfFile(data_);
+	if (mapping_) CloseHandle(mapping_);
+	if (file_) CloseHandle(file_);
+
+	data_ = nullptr;
+	mapping_ = nullptr;
+	file_ = nullptr;
+	size_ = 0;
+}
+
+void MappedFile::Swap(MappedFile& other) noexcept
+{
+	std::swap(data_, other.data_);
+	std::swap(size_, other.size_);
+	std::swap(writable_, other.writable_);
+	std::swap(file_, other.file_);
+	std::swap(mapping_, other.mapping_);
+}
+
+#else
+
+MappedFile::MappedFile(const std::filesystem::path& path)
+{
+	file_ = ::open(path.c_str(), O_RDONLY);
+	if (file_ < 0) ThrowMappingError(path, "open");
+
+	struct stat status{ };
+	if (::fstat(file_, &status) != 0) { Close(); ThrowMappingError(path, "size"); }
+	size_ = static_cast<std::size_t>(status.st_size);
+
+	// Empty files cannot be mapped, they are left open with no data
+
+	if (size_ == 0) return;
+
+	void* data = ::mmap(nullptr, size_, PROT_READ, MAP_SHARED, file_, 0);
+	if (data == MAP_FAILED) { Close(); ThrowMappingError(path, "map"); }
+	data_ = static_cast<std::byte*>(data);
+}
+
+MappedFile::MappedFile(const std::filesystem::path& path, std::size_t size)
+	: size_{ size }
+	, writable_{ true }
+{
+	file_ = ::open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+	if (file_ < 0) ThrowMappingError(path, "create");
+
+	// Reserve the blocks up front so that writes through the mapping cannot fail
+	// for lack of disk space, where supported
+
+#if defined(__linux__)
+	if (const int error = ::posix_fallocate(file_, 0, static_cast<off_t>(size)); error != 0)
+	{
+		Close();
+		errno = error;
+		ThrowMappingError(path, "preallocate");
+	}
+#else
+	if (::ftruncate(file_, static_cast<off_t>(size)) != 0) { Close(); ThrowMappingError(path, "preallocate"); }
+#endif
+
+	void* data = ::mmap(nullptr, size_, PROT_READ | PROT_WRITE, MAP_SHARED, file_, 0);
+	if (data == MAP_FAILED) { Close(); ThrowMappingError(path, "map"); }
+	data_ = static_cast<std::byte*>(data);
+}
+
+void MappedFile::Flush()
+{
+	if (data_ && writable_) ::msync(data_, size_, MS_SYNC);
+}
+
+void MappedFile::Close()
+{
+	if (data_) ::munmap(data_, size_);
+	if (file_ >= 0) ::close(file_);
+
+	data_ = nullptr;
+	file_ = -1;
+	size_ = 0;
+}
+
+void MappedFile::Swap(MappedFile& other) noexcept
+{
+	std::swap(data_, other.data_);
+	std::swap(size_, other.size_);
+	std::swap(writable_, other.writable_);
+	std::swap(file_, other.file_);
+}
+
+#endif
+
+MappedFile::~MappedFile()
+{
+	Close();
+}
+
+MappedFile::MappedFile(MappedFile&& other) noexcept
+{
+	Swap(other);
+}
+
+MappedFile& MappedFile::operator=(MappedFile&& other) noexcept
+{
+	if (this != &other)
+	{
+		Close();
+		Swap(other);
+	}
+	return *this;
+}
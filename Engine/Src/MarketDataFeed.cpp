@@ -0,0 +1,5 @@
+#include "../Include/MarketData/MarketDataFeed.h"
+
+MarketDataFeed::MarketDataFeed(DeltaHandler deltaHandler, std::size_t capacity)
+	: ring_{ BatchHandler<LevelDelta>{ std::move(deltaHandler) }, capacity }
+{ }
@@ -1,48 +1,240 @@
 #include "../Include/OrderBook/OrderBook.h"
-
-void OrderBook::AddOrderToQueue(OrderId id, OrderType type, Side side, Price price, Quantity quantity)
+#include "../Include/OrderBook/PriceMap.h"
+#include "../Include/OrderBook/PriceLadder.h"
+#include "../Include/Journal/JournalReader.h"
+#include "../Include/Snapshot/BookSnapshot.h"
+#include "../Include/Util/MappedFile.h"
+
+#include <array>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+
+namespace
 {
-	queueManager_.EnqueueEvent(QueueEvent
+	template <typename Compare>
+	std::unique_ptr<PriceLevels> MakePriceLevels(const OrderBookConfig& config)
+	{
+		switch (config.levelStorage_)
 		{
-			EventType::AddOrder,
-			AddOrderPayload{ id, type, side, price, quantity}
-		});
+		case LevelStorage::Ladder: return std::make_unique<PriceLadder<Compare>>(config.ladderTicks_);
+		case LevelStorage::Map: return std::make_unique<PriceMap<Compare>>();
+		default: throw std::logic_error("Unsupported level storage.");
+		}
+	}
+
+	// Number of levels walked in lockstep when copying the book into a snapshot
+	constexpr std::size_t SnapshotLanes = 16;
+
+	// Copies the orders of every level to its slot in orders, starting from the given
+	// order and index, and totals the remaining quantity of each level
+
+	void CopyLevelsInterleaved(std::vector<SnapshotLevel>& levels,
+		const std::vector<std::pair<OrderPointers::Iterator, std::size_t>>& levelStarts,
+		std::vector<SnapshotOrder>& orders)
+	{
+		struct Lane
+		{
+			OrderPointers::Iterator order_;
+			std::size_t level_;
+			std::size_t next_;
+			std::size_t end_;
+		};
+
+		std::array<Lane, SnapshotLanes> lanes{ };
+		std::size_t active = 0;
+		std::size_t nextLevel = 0;
+
+		auto startLevel = [&](Lane& lane)
+			{
+				for (; nextLevel < levels.size(); ++nextLevel)
+				{
+					const auto& [order, start] = levelStarts[nextLevel];
+					if (levels[nextLevel].count_ == 0) continue;
+
+					lane = Lane{ order, nextLevel, start, start + levels[nextLevel].count_ };
+					++nextLevel;
+					return true;
+				}
+				return false;
+			};
+
+		while (active < lanes.size() && startLevel(lanes[active]))
+			++active;
+
+		while (active > 0)
+		{
+			for (std::size_t i = 0; i < active; )
+			{
+				auto& lane = lanes[i];
+				const auto order = *lane.order_;
+
+				levels[lane.level_].quantity_ += order->GetRemainingQuantity();
+				orders[lane.next_++] = SnapshotOrder
+				{
+					order->GetOrderId(),
+					order->GetInitialQuantity(),
+					order->GetRemainingQuantity(),
+					order->GetOrderType()
+				};
+				++lane.order_;
+
+				// Move on to the next level once done, retiring the lane if none are left
+
+				if (lane.next_ == lane.end_ && !startLevel(lane))
+				{
+					lane = lanes[--active];
+					continue;
+				}
+
+				++i;
+			}
+		}
+	}
 }
 
-void OrderBook::ModifyOrderToQueue(OrderId id, Side side, Price price, Quantity quantity)
+template <typename Threading>
+BasicOrderBook<Threading>::BasicOrderBook(const OrderBookConfig& config)
+	: BasicOrderBook(config, nullptr)
+{ }
+
+template <typename Threading>
+BasicOrderBook<Threading>::BasicOrderBook(const OrderBookConfig& config, QueueManager& sharedQueue) requires (Threading::Queued)
+	: BasicOrderBook(config, &sharedQueue)
+{ }
+
+template <typename Threading>
+BasicOrderBook<Threading>::BasicOrderBook(const OrderBookConfig& config, QueueManager* sharedQueue)
+	: bids_{ MakePriceLevels<std::greater<Price>>(config) }
+	, asks_{ MakePriceLevels<std::less<Price>>(config) }
+	, orders_{ config.orderIdMapMode_, config.maxOrderId_ }
+	, symbolId_{ config.symbolId_ }
+	, reportSink_{ config.reportSink_ }
+	, journal_{ config.journal_ }
+	, auditLog_{ config.auditLog_ }
+	, marketDataFeed_{ config.marketDataFeed_ }
+	, publishTopOfBook_{ config.publishTopOfBook_ }
+	, ownQueue_{ (!Threading::Queued || sharedQueue) ? nullptr : std::make_unique<QueueManager>(
+		[this](std::span<const QueueEvent> events) { HandleEvents(events); }, config.queue_) }
+	, queueManager_{ sharedQueue ? sharedQueue : ownQueue_.get() }
 {
-	queueManager_.EnqueueEvent(QueueEvent
-		{
-			EventType::ModifyOrder,
-			ModifyOrderPayload{ id, side, price, quantity }
-		});
+	orderPool_.Reserve(config.reservedOrders_);
+	orders_.Reserve(config.reservedOrders_);
+
+	if (!journal_ && auditLog_) FileLogger::Init("Debug/OrderBook.Log");
+	LogInternal(JournalEvent::BookInitialized);
 }
 
-void OrderBook::CancelOrderToQueue(OrderId id)
+template <typename Threading>
+BasicOrderBook<Threading>::~BasicOrderBook()
 {
-	queueManager_.EnqueueEvent(QueueEvent
-		{
-			EventType::CancelOrder,
-			CancelOrderPayload{ id }
-		});
+	LogInternal(JournalEvent::BookDestroyed);
+
+	// Only books that took a share of the FileLogger give one back
+
+	if (!journal_ && auditLog_) FileLogger::Cleanup();
+}
+
+template <typename Threading>
+Ticket BasicOrderBook<Threading>::AddOrderToQueue(OrderId id, OrderType type, Side side, Price price, Quantity quantity, ProducerId producer) requires (Threading::Queued)
+{
+	QueueEvent event{ AddOrderPayload{ id, type, side, price, quantity, symbolId_ } };
+	event.producer_ = producer;
+	return queueManager_->EnqueueEvent(event);
+}
+
+template <typename Threading>
+Ticket BasicOrderBook<Threading>::ModifyOrderToQueue(OrderId id, Side side, Price price, Quantity quantity, ProducerId producer) requires (Threading::Queued)
+{
+	QueueEvent event{ ModifyOrderPayload{ id, side, price, quantity, symbolId_ } };
+	event.producer_ = producer;
+	return queueManager_->EnqueueEvent(event);
+}
+
+template <typename Threading>
+Ticket BasicOrderBook<Threading>::CancelOrderToQueue(OrderId id, ProducerId producer) requires (Threading::Queued)
+{
+	QueueEvent event{ CancelOrderPayload{ id, symbolId_ } };
+	event.producer_ = producer;
+	return queueManager_->EnqueueEvent(event);
+}
+
+template <typename Threading>
+Ticket BasicOrderBook<Threading>::SubmitBatch(std::span<const QueueEvent> events) requires (Threading::Queued)
+{
+	return queueManager_->EnqueueEvents(events);
+}
+
+template <typename Threading>
+ProducerId BasicOrderBook<Threading>::AddProducer(CompletionRing& completions) requires (Threading::Queued)
+{
+	// Taken under the book lock, as the matcher reads the rings while handling
+
+	std::scoped_lock ordersLock{ ordersMutex_ };
+
+	if (completionRings_.size() > std::numeric_limits<ProducerId>::max())
+		throw std::logic_error("A book takes at most 255 producers.");
+
+	completionRings_.push_back(&completions);
+	return static_cast<ProducerId>(completionRings_.size() - 1);
+}
+
+template <typename Threading>
+const OrderResult& BasicOrderBook<Threading>::AddOrder(OrderId id, OrderType type, Side side, Price price, Quantity quantity) requires (!Threading::Queued)
+{
+	return HandleInline(AddOrderPayload{ id, type, side, price, quantity, symbolId_ });
 }
 
-void OrderBook::Display() const
+template <typename Threading>
+const OrderResult& BasicOrderBook<Threading>::ModifyOrder(OrderId id, Side side, Price price, Quantity quantity) requires (!Threading::Queued)
 {
-	queueManager_.WaitForAllEvents();
+	return HandleInline(ModifyOrderPayload{ id, side, price, quantity, symbolId_ });
+}
+
+template <typename Threading>
+const OrderResult& BasicOrderBook<Threading>::CancelOrder(OrderId id) requires (!Threading::Queued)
+{
+	return HandleInline(CancelOrderPayload{ id, symbolId_ });
+}
+
+template <typename Threading>
+template <typename T>
+const OrderResult& BasicOrderBook<Threading>::HandleInline(const T& payload)
+{
+#if defined(ORDERBOOK_LATENCY_TRACE)
+	const std::uint64_t startedAt = ReadTimestamp();
+	loggingTicks_ = 0;
+#endif
+
+	// Numbered as the queue would have, after the last request handled or recovered
+
+	++eventSequence_;
+	HandleRequestInternal(payload);
+
+#if defined(ORDERBOOK_LATENCY_TRACE)
+	TraceEventInternal(startedAt);
+#endif
+
+	return result_;
+}
+
+template <typename Threading>
+void BasicOrderBook<Threading>::Display() const
+{
+	if constexpr (Threading::Queued) queueManager_->WaitForAllEvents();
 
 	std::scoped_lock ordersLock{ ordersMutex_ };
 	
-	if (orders_.empty())
+	if (orders_.Empty())
 	{
 		std::cout << "Orderbook is empty!\n" << std::endl;
 		return;
 	}
 
 	std::cout << "------ Displaying the Orderbook ------\n";
-	std::cout << std::format("Orderbook contains {} outstanding orders\n", orders_.size()) << std::endl;
+	std::cout << std::format("Orderbook contains {} outstanding orders\n", orders_.Size()) << std::endl;
 
-	auto orderInfos = GetOrderInfos();
+	auto orderInfos = GetOrderInfosInternal();
 	auto bidLevelInfos = orderInfos.GetBids();
 	auto askLevelInfos = orderInfos.GetAsks();
 
@@ -63,129 +255,433 @@ void OrderBook::Display() const
 	std::cout << "\n";
 }
 
-std::size_t OrderBook::Size() const
+template <typename Threading>
+std::size_t BasicOrderBook<Threading>::Size() const
 {
-	queueManager_.WaitForAllEvents();
+	if constexpr (Threading::Queued) queueManager_->WaitForAllEvents();
 
 	std::scoped_lock ordersLock{ ordersMutex_ };
-	return orders_.size();
+	return orders_.Size();
 }
 
-OrderBookLevelInfos OrderBook::GetOrderInfos() const
+template <typename Threading>
+OrderBookLevelInfos BasicOrderBook<Threading>::GetOrderInfos() const
 {
-	queueManager_.WaitForAllEvents();
+	if constexpr (Threading::Queued) queueManager_->WaitForAllEvents();
+
+	std::scoped_lock ordersLock{ ordersMutex_ };
+	return GetOrderInfosInternal();
+}
 
+template <typename Threading>
+OrderBookLevelInfos BasicOrderBook<Threading>::GetOrderInfosInternal() const
+{
 	LevelInfos bidInfos, askInfos;
-	bidInfos.reserve(orders_.size());
-	askInfos.reserve(orders_.size());
+	bidInfos.reserve(orders_.Size());
+	askInfos.reserve(orders_.Size());
+
+	bids_->ForEachLevel([&](Price price, const PriceLevel& level)
+		{ bidInfos.push_back(LevelInfo{ price, level.quantity_ }); });
+
+	asks_->ForEachLevel([&](Price price, const PriceLevel& level)
+		{ askInfos.push_back(LevelInfo{ price, level.quantity_ }); });
+
+	return OrderBookLevelInfos{ bidInfos, askInfos };
+}
+
+template <typename Threading>
+TopOfBook BasicOrderBook<Threading>::GetTopOfBook() const
+{
+	return topOfBook_.Load();
+}
+
+template <typename Threading>
+DepthSnapshot BasicOrderBook<Threading>::GetDepthSnapshot(std::size_t depth) const
+{
+	DepthSnapshot snapshot;
+	snapshot.symbolId_ = symbolId_;
+	snapshot.bids_.reserve(depth);
+	snapshot.asks_.reserve(depth);
+
+	// Taken between two requests without waiting for the queue to drain
+
+	std::scoped_lock ordersLock{ ordersMutex_ };
+	snapshot.sequence_ = deltaSequence_;
 
-	auto CreateLevelInfos = [](Price price, const OrderPointers& orders)
+	auto copyLevels = [&](const PriceLevels& side, DepthLevels& levels)
 		{
-			return LevelInfo{ price, std::accumulate(orders.begin(), orders.end(), (Quantity)0,
-				[](Quantity runningSum, const OrderPointer& order)
-				{ return runningSum + order->GetRemainingQuantity(); }) };
+			side.ForEachBestLevel(depth, [&](Price price, const PriceLevel& level)
+				{ levels.push_back(DepthLevel{ price, level.quantity_, level.count_ }); });
 		};
 
-	for (const auto& [price, orders] : bids_)
-		bidInfos.push_back(CreateLevelInfos(price, orders));
+	copyLevels(*bids_, snapshot.bids_);
+	copyLevels(*asks_, snapshot.asks_);
 
-	for (const auto& [price, orders] : asks_)
-		askInfos.push_back(CreateLevelInfos(price, orders));
+	return snapshot;
+}
 
-	return OrderBookLevelInfos{ bidInfos, askInfos };
+template <typename Threading>
+std::uint64_t BasicOrderBook<Threading>::TakeSnapshot(const std::filesystem::path& path) const
+{
+	SnapshotHeader header{ .symbolId_ = symbolId_ };
+	std::vector<SnapshotLevel> levels;
+	std::vector<SnapshotOrder> orders;
+
+	// Copy the book between two requests, holding the lock only for the copy
+
+	{
+		std::scoped_lock ordersLock{ ordersMutex_ };
+
+		header.sequence_ = eventSequence_;
+		header.bidLevels_ = bids_->Size();
+		header.askLevels_ = asks_->Size();
+		header.orders_ = orders_.Size();
+
+		levels.reserve(bids_->Size() + asks_->Size());
+		orders.resize(orders_.Size());
+
+		// Note where each level starts in the orders, as they are laid out level by level
+
+		std::vector<std::pair<OrderPointers::Iterator, std::size_t>> levelStarts;
+		levelStarts.reserve(levels.capacity());
+
+		auto addLevel = [&](Price price, const PriceLevel& level)
+			{
+				const std::size_t start = levelStarts.empty() ? 0 : levelStarts.back().second + levels.back().count_;
+				levels.push_back(SnapshotLevel{ .price_ = price, .count_ = level.count_ });
+				levelStarts.emplace_back(level.orders_.begin(), start);
+			};
+
+		bids_->ForEachLevel(addLevel);
+		asks_->ForEachLevel(addLevel);
+
+		// Walking one level at a time stalls on a cache miss per order, so several levels
+		// are walked in lockstep to keep their misses in flight at once
+
+		CopyLevelsInterleaved(levels, levelStarts, orders);
+	}
+
+	// Write to a temporary file which replaces the snapshot once complete, so a crash
+	// never leaves a partial snapshot behind
+
+	auto temporaryPath = path;
+	temporaryPath += ".tmp";
+
+	{
+		MappedFile file{ temporaryPath, SnapshotSize(header) };
+
+		std::memcpy(file.Data(), &header, sizeof(header));
+		if (!levels.empty())
+			std::memcpy(file.Data() + SnapshotLevelsOffset(), levels.data(), levels.size() * sizeof(SnapshotLevel));
+		if (!orders.empty())
+			std::memcpy(file.Data() + SnapshotOrdersOffset(header), orders.data(), orders.size() * sizeof(SnapshotOrder));
+
+		file.Flush();
+	}
+
+	std::filesystem::rename(temporaryPath, path);
+	return header.sequence_;
 }
 
-Trades OrderBook::AddOrderInternal(const AddOrderPayload& payload)
+template <typename Threading>
+void BasicOrderBook<Threading>::Recover(const std::filesystem::path& snapshotPath, const std::filesystem::path& journalPath)
 {
-	// Parse the payload into a new Order instance
-	auto order = std::make_shared<Order>
-	(
-		payload.orderId_,
-		payload.orderType_,
-		payload.side_,
-		payload.price_,
-		payload.quantity_
-	);
+	const MappedFile file{ snapshotPath };
+
+	if (file.Size() < sizeof(SnapshotHeader))
+		throw std::runtime_error(std::format("Snapshot {} is truncated.", snapshotPath.string()));
+
+	const auto& header = *reinterpret_cast<const SnapshotHeader*>(file.Data());
+
+	if (header.magic_ != SnapshotHeader::Magic || header.version_ != SnapshotHeader::CurrentVersion)
+		throw std::runtime_error(std::format("{} is not a version {} snapshot.", snapshotPath.string(), SnapshotHeader::CurrentVersion));
+
+	if (file.Size() < SnapshotSize(header))
+		throw std::runtime_error(std::format("Snapshot {} is truncated.", snapshotPath.string()));
+
+	if (header.symbolId_ != symbolId_)
+		throw std::logic_error(std::format("Snapshot of symbol {} cannot recover the book of symbol {}.", header.symbolId_, symbolId_));
+
+	std::scoped_lock ordersLock{ ordersMutex_ };
+
+	if (!orders_.Empty())
+		throw std::logic_error("Only an empty orderbook can be recovered.");
+
+	if constexpr (Threading::Queued)
+	{
+		if (!queueManager_->Idle())
+			throw std::logic_error("Only an orderbook without queued requests can be recovered.");
+	}
+
+	orderPool_.Reserve(static_cast<std::size_t>(header.orders_));
+	orders_.Reserve(static_cast<std::size_t>(header.orders_));
+
+	// Levels are rebuilt in priority order, each from its run of orders
+
+	const auto* levels = reinterpret_cast<const SnapshotLevel*>(file.Data() + SnapshotLevelsOffset());
+	const auto* orders = reinterpret_cast<const SnapshotOrder*>(file.Data() + SnapshotOrdersOffset(header));
+	std::size_t remaining = static_cast<std::size_t>(header.orders_);
+
+	auto restoreSide = [&](PriceLevels& side, Side orderSide, std::span<const SnapshotLevel> sideLevels)
+		{
+			for (const auto& snapshotLevel : sideLevels)
+			{
+				if (snapshotLevel.count_ > remaining)
+					throw std::runtime_error(std::format("Snapshot {} is corrupt.", snapshotPath.string()));
+				remaining -= snapshotLevel.count_;
+
+				auto& level = side.GetOrCreateLevel(snapshotLevel.price_);
+
+				for (std::uint32_t i = 0; i < snapshotLevel.count_; ++i, ++orders)
+				{
+					if (!orders_.Accepts(orders->orderId_))
+						throw std::logic_error(std::format("Order {} of snapshot {} is beyond the largest order id of the book.",
+							orders->orderId_, snapshotPath.string()));
+
+					auto order = orderPool_.Acquire
+					(
+						orders->orderId_,
+						orders->orderType_,
+						orderSide,
+						snapshotLevel.price_,
+						orders->initialQuantity_
+					);
+
+					order->Fill(orders->initialQuantity_ - orders->remainingQuantity_);
+					level.orders_.push_back(order);
+					orders_.Insert(order->GetOrderId(), order);
+				}
+
+				side.AddToLevel(snapshotLevel.price_, snapshotLevel.quantity_, snapshotLevel.count_);
+			}
+		};
+
+	restoreSide(*bids_, Side::Buy, { levels, static_cast<std::size_t>(header.bidLevels_) });
+	restoreSide(*asks_, Side::Sell, { levels + header.bidLevels_, static_cast<std::size_t>(header.askLevels_) });
+	eventSequence_ = header.sequence_;
+
+	if (!journalPath.empty())
+		ReplayJournalInternal(journalPath, header.sequence_);
+
+	// Requests queued from here on are numbered after the last one recovered, as
+	// inline requests are, so that later snapshots and journals carry on from it
+
+	if constexpr (Threading::Queued) queueManager_->ResumeFrom(eventSequence_);
+
+	if (publishTopOfBook_) PublishTopOfBookInternal();
+}
+
+template <typename Threading>
+void BasicOrderBook<Threading>::ReplayJournalInternal(const std::filesystem::path& journalPath, std::uint64_t sequence)
+{
+	const JournalReader reader{ journalPath };
+
+	// Replayed requests were logged, reported and published before the restart
+
+	auto* reportSink = std::exchange(reportSink_, nullptr);
+	auto* marketDataFeed = std::exchange(marketDataFeed_, nullptr);
+	replaying_ = true;
+
+	reader.ForEachRecord([&](const JournalRecord& record)
+		{
+			if (record.symbolId_ != symbolId_ || record.sequence_ <= sequence)
+				return;
+
+			eventSequence_ = record.sequence_;
+
+			// Only added, cancelled and reduced orders changed the book, as matching is
+			// deterministic the fills follow from replaying the adds
+
+			switch (record.event_)
+			{
+			case JournalEvent::OrderAdded:
+				AddOrderInternal(AddOrderPayload
+					{
+						record.orderId_,
+						record.orderType_,
+						record.side_,
+						record.price_,
+						record.quantity_,
+						symbolId_
+					});
+				break;
+			case JournalEvent::OrderCancelled:
+				// Unfilled FAK remainders were already cancelled by replaying their add
+
+				if (auto order = orders_.Find(record.orderId_))
+					CancelOrderInternal(order);
+				break;
+			case JournalEvent::OrderReduced:
+				if (auto order = orders_.Find(record.orderId_))
+					ReduceOrderInternal(order, order->GetRemainingQuantity() - record.quantity_);
+				break;
+			default:
+				break;
+			}
+		});
+
+	replaying_ = false;
+	reportSink_ = reportSink;
+	marketDataFeed_ = marketDataFeed;
+}
+
+template <typename Threading>
+void BasicOrderBook<Threading>::AddOrderInternal(const AddOrderPayload& payload)
+{
+	// Branch on the side and type once, the kernels have both fixed
+
+	if (payload.side_ == Side::Buy) DispatchAddOrder<Side::Buy>(payload);
+	else DispatchAddOrder<Side::Sell>(payload);
+}
+
+template <typename Threading>
+template <Side S>
+void BasicOrderBook<Threading>::DispatchAddOrder(const AddOrderPayload& payload)
+{
+	switch (payload.orderType_)
+	{
+	case OrderType::GoodTillCancel: AddOrderKernel<S, OrderType::GoodTillCancel>(payload); break;
+	case OrderType::Market: AddOrderKernel<S, OrderType::Market>(payload); break;
+	case OrderType::FillAndKill: AddOrderKernel<S, OrderType::FillAndKill>(payload); break;
+	case OrderType::FillOrKill: AddOrderKernel<S, OrderType::FillOrKill>(payload); break;
+	default: throw std::logic_error("Unsupported order type.");
+	}
+}
+
+template <typename Threading>
+template <Side S, OrderType T>
+void BasicOrderBook<Threading>::AddOrderKernel(const AddOrderPayload& payload)
+{
+	auto& opposite = LevelsOf<OppositeSide<S>>();
 
+	// Validate the payload before taking an order from the pool
+
+	if (orders_.Contains(payload.orderId_))
+	{
+		LogInternal(JournalEvent::DuplicateAddRejected, payload.orderId_);
+		ReportReject(payload.orderId_, S, payload.price_, payload.quantity_, RejectReason::DuplicateOrderId);
+		return;
+	}
 
-	if (orders_.contains(order->GetOrderId()))
+	if (!orders_.Accepts(payload.orderId_))
 	{
-		FileLogger::Get()->info(
-			"{}: Add order request denied. The order already exists.",
-			order->GetOrderId());
-		return { };
+		LogInternal(JournalEvent::OrderIdRejected, payload.orderId_);
+		ReportReject(payload.orderId_, S, payload.price_, payload.quantity_, RejectReason::OrderIdOutOfRange);
+		return;
 	}
 
 	// Check if FAK can be matched
 
-	if (order->GetOrderType() == OrderType::FillAndKill &&
-		!CanMatchInternal(order->GetSide(), order->GetPrice()))
+	if constexpr (T == OrderType::FillAndKill)
 	{
-		FileLogger::Get()->info(
-			"{}: Add order request denied. Fill and kill order cannot be matched.",
-			order->GetOrderId());
-		return { };
+		if (!CanMatchKernel<S>(payload.price_))
+		{
+			LogInternal(JournalEvent::FillAndKillRejected, payload.orderId_);
+			ReportReject(payload.orderId_, S, payload.price_, payload.quantity_, RejectReason::FillAndKillMiss);
+			return;
+		}
 	}
 
 	// Check if FOK can be fully filled
 
-	if (order->GetOrderType() == OrderType::FillOrKill &&
-		!CanBeFullyFilledInternal(order->GetSide(), order->GetPrice(), order->GetRemainingQuantity()))
-	{		
-		FileLogger::Get()->info(
-			"{}: Add order request denied. Fill or kill order cannot be filled.",
-			order->GetOrderId());
-		return { };
+	if constexpr (T == OrderType::FillOrKill)
+	{
+		if (!CanBeFullyFilledKernel<S>(payload.price_, payload.quantity_))
+		{
+			LogInternal(JournalEvent::FillOrKillRejected, payload.orderId_);
+			ReportReject(payload.orderId_, S, payload.price_, payload.quantity_, RejectReason::FillOrKillMiss);
+			return;
+		}
 	}
 
 	// Set the price if the order is a market order
 
-	auto setMarketPrice = [&](auto& order, auto& ordersOtherSide)
+	Price price = payload.price_;
+
+	if constexpr (T == OrderType::Market)
 	{
-		const auto& [worstPrice, _] = *ordersOtherSide.rbegin();
-		order->SetMarketPrice(worstPrice);
-	};
+		if (opposite.Empty())
+		{
+			ReportReject(payload.orderId_, S, payload.price_, payload.quantity_, RejectReason::NoLiquidity);
+			return;
+		}
+
+		price = opposite.WorstPrice();
+	}
+
+	// Parse the payload into a new Order instance
+
+	auto order = orderPool_.Acquire
+	(
+		payload.orderId_,
+		T,
+		S,
+		price,
+		payload.quantity_
+	);
+
+	// Log successful add order
+
+	LogInternal(JournalEvent::OrderAdded, order);
 
-	if (order->GetOrderType() == OrderType::Market)
+	// Match against the opposite side first, trades are reported as fills
+
+	MatchOrdersKernel<S>(order);
+
+	if (order->IsFilled())
 	{
-		if (order->GetSide() == Side::Buy && !asks_.empty())
-			setMarketPrice(order, asks_);
-		else if (order->GetSide() == Side::Sell && !bids_.empty())
-			setMarketPrice(order, bids_);
-		else
-			return { };
+		orderPool_.Release(order);
+		return;
 	}
 
-	// Insert the order at the given side and price
+	// Cancel the remainder of a FAK order, it never rests on the book
 
-	auto& level = (order->GetSide() == Side::Buy)
-		? bids_[order->GetPrice()]
-		: asks_[order->GetPrice()];
+	if constexpr (T == OrderType::FillAndKill)
+	{
+		ReportCancel(order);
+		LogInternal(JournalEvent::OrderCancelled, order);
+		orderPool_.Release(order);
+	}
+	else
+	{
+		// Add the remainder to the aggregate orders map and rest it on the book
+
+		orders_.Insert(order->GetOrderId(), order);
+		RestOrderInternal(order);
+	}
+}
 
-	level.push_back(order);
+template <typename Threading>
+void BasicOrderBook<Threading>::RestOrderInternal(OrderPointer order)
+{
+	// Insert the order at the given side and price
 
-	// Add order to the aggregate orders map
+	auto& level = (order->GetSide() == Side::Buy)
+		? bids_->GetOrCreateLevel(order->GetPrice())
+		: asks_->GetOrCreateLevel(order->GetPrice());
 
-	auto iterator = std::prev(level.end());
-	orders_.insert({ order->GetOrderId(), OrderEntry { order, iterator } });
+	level.orders_.push_back(order);
 
 	// Update the level info struct
 
 	UpdateLevelOnAddOrder(order);
+}
 
-	// Log successful add order
-
-	FileLogger::Get()->info(
-		"{}: Order added successfully. Info: {{ {} }}",
-		order->GetOrderId(),
-		order->ToString());
+template <typename Threading>
+void BasicOrderBook<Threading>::RemoveFromLevelInternal(OrderPointer order)
+{
+	auto& side = (order->GetSide() == Side::Buy) ? *bids_ : *asks_;
+	const auto price = order->GetPrice();
+	auto& level = side.GetLevel(price).orders_;
 
-	// Run matching algorithm and return new trades (if any)
+	// If removal of order leaves a level empty, clear the level
 
-	return MatchOrdersInternal();
+	level.erase(order);
+	if (level.empty()) side.EraseLevel(price);
 }
 
-Trades OrderBook::ModifyOrderInternal(const ModifyOrderPayload& payload)
+template <typename Threading>
+void BasicOrderBook<Threading>::ModifyOrderInternal(const ModifyOrderPayload& payload)
 {
 	// Parse the payload into an OrderModify instance
 
@@ -197,281 +693,550 @@ Trades OrderBook::ModifyOrderInternal(const ModifyOrderPayload& payload)
 		payload.quantity_
 	};
 
-	OrderType orderType;
+	auto existingOrder = orders_.Find(order.GetOrderId());
 
-	if (!orders_.contains(order.GetOrderId()))
+	if (!existingOrder)
 	{
-		FileLogger::Get()->info(
-			"{}: Modify order request denied. Order does not exist.",
-			order.GetOrderId());
-		return { };
+		LogInternal(JournalEvent::ModifyRejected, order.GetOrderId());
+		ReportReject(payload.orderId_, payload.side_, payload.price_, payload.quantity_, RejectReason::OrderNotFound);
+		return;
 	}
 
-	const auto& [existingOrder, _] = orders_.at(order.GetOrderId());
-	orderType = existingOrder->GetOrderType();
+	OrderType orderType = existingOrder->GetOrderType();
 
-	FileLogger::Get()->info(
-		"{}: Request to modify order accepted.",
-		order.GetOrderId());
+	LogInternal(JournalEvent::ModifyAccepted, order.GetOrderId());
 
-	// Create a CancelOrderPayload for the existing order and process
+	// Amending the quantity to zero cancels the order
 
-	auto oldOrderId = CancelOrderPayload{ order.GetOrderId() };
-	CancelOrderInternal(oldOrderId);
+	if (order.GetQuantity() == 0)
+	{
+		ReportCancel(existingOrder);
+		CancelOrderInternal(existingOrder);
+		return;
+	}
 
-	// Create an AddOrderPayload for the modified order and process
+	// A smaller quantity at the same side and price is applied in place and keeps
+	// the time priority of the order, the same quantity leaves it untouched
 
-	auto newOrderPayload = AddOrderPayload
+	if (order.GetSide() == existingOrder->GetSide() &&
+		order.GetPrice() == existingOrder->GetPrice() &&
+		order.GetQuantity() <= existingOrder->GetRemainingQuantity())
 	{
-		order.GetOrderId(),
-		orderType,
-		order.GetSide(),
-		order.GetPrice(),
-		order.GetQuantity()
-	};
+		if (order.GetQuantity() < existingOrder->GetRemainingQuantity())
+			ReduceOrderInternal(existingOrder, existingOrder->GetRemainingQuantity() - order.GetQuantity());
+		return;
+	}
+
+	// Market orders are repriced on arrival, so they are cancelled and added again
+
+	if (orderType == OrderType::Market)
+	{
+		CancelOrderInternal(existingOrder);
+		AddOrderInternal(AddOrderPayload
+			{
+				order.GetOrderId(),
+				orderType,
+				order.GetSide(),
+				order.GetPrice(),
+				order.GetQuantity()
+			});
+		return;
+	}
+
+	// Anything else moves the existing order to the back of its new level
 
-	return AddOrderInternal(newOrderPayload);
+	MoveOrderInternal(existingOrder, order.GetSide(), order.GetPrice(), order.GetQuantity());
 }
 
-void OrderBook::CancelOrderInternal(const CancelOrderPayload& payload)
+template <typename Threading>
+void BasicOrderBook<Threading>::ReduceOrderInternal(OrderPointer order, Quantity quantity)
 {
-	// Parse the payload into an OrderId instance
+	order->Reduce(quantity);
 
-	auto orderId = payload.orderId_;
+	UpdateLevelsInternal(order->GetSide(), order->GetPrice(), quantity, OrderEvent::ReduceOrder);
 
-	if (!orders_.contains(orderId))
-		FileLogger::Get()->info(
-			"{}: Request to cancel order denied. Order does not exist.",
-			orderId);
-		return;
+	LogInternal(JournalEvent::OrderReduced, order);
+}
 
-	// Remove order from the aggregate orders map
+template <typename Threading>
+void BasicOrderBook<Threading>::MoveOrderInternal(OrderPointer order, Side side, Price price, Quantity quantity)
+{
+	// The order keeps its pool slot and its entry in the aggregate orders map,
+	// it is journalled as cancelled and added again as it loses priority
 
-	const auto [order, iterator] = orders_.at(orderId);
-	orders_.erase(orderId);
+	UpdateLevelOnCancelOrder(order);
+	RemoveFromLevelInternal(order);
+	LogInternal(JournalEvent::OrderCancelled, order);
 
-	// Lambda to remove the order from its level on the orderbook
+	order->Amend(side, price, quantity);
+	LogInternal(JournalEvent::OrderAdded, order);
 
-	auto removeOrderFromLevel = [&](auto& side, auto& order)
-		{
-			auto price = order->GetPrice();
-			auto& level = side.at(price);
+	// Match at the new price before resting the remainder
 
-			// If removal of order leaves a level empty, clear the level
+	MatchOrdersInternal(order);
 
-			level.erase(iterator);
-			if (level.empty()) side.erase(price);
-		};
+	if (order->IsFilled())
+	{
+		orders_.Erase(order->GetOrderId());
+		orderPool_.Release(order);
+		return;
+	}
 
-	if (order->GetSide() == Side::Sell) removeOrderFromLevel(asks_, order);
-	if (order->GetSide() == Side::Buy) removeOrderFromLevel(bids_, order);
+	RestOrderInternal(order);
+}
+
+template <typename Threading>
+void BasicOrderBook<Threading>::CancelOrderInternal(const CancelOrderPayload& payload)
+{
+	// Parse the payload into an OrderId instance
 
-	// Update the levels info struct
+	auto orderId = payload.orderId_;
+	auto order = orders_.Find(orderId);
 
-	UpdateLevelOnCancelOrder(order);
+	if (!order)
+	{
+		LogInternal(JournalEvent::CancelRejected, orderId);
+		ReportReject(orderId, Side{ }, Price{ }, Quantity{ }, RejectReason::OrderNotFound);
+		return;
+	}
 
-	FileLogger::Get()->info(
-		"{}: Order cancelled successfully. Info: {{ {} }}",
-		orderId,
-		order->ToString());
+	ReportCancel(order);
+	CancelOrderInternal(order);
 }
 
-Trades OrderBook::MatchOrdersInternal()
+template <typename Threading>
+void BasicOrderBook<Threading>::CancelOrderInternal(OrderPointer order)
 {
-	Trades trades;
-	trades.reserve(std::min(bids_.size(), asks_.size()));
+	// Remove order from the aggregate orders map
 
-	// Lambda to remove (filled) orders from the level and aggregate of orders
+	auto orderId = order->GetOrderId();
+	orders_.Erase(orderId);
 
-	auto removeOrder = [&](auto& order, auto& level)
-		{
-			level.pop_front();
-			orders_.erase(order->GetOrderId());
-		};
+	// Update the levels info struct while the level still exists, then take the
+	// order off its level
 
-	// Lambda to cancel FAK orders for a given side of the OB
+	UpdateLevelOnCancelOrder(order);
+	RemoveFromLevelInternal(order);
 
-	auto cancelFAK = [&](auto& side)
-		{
-			auto& [_, orders] = *side.begin();
-			auto& best = orders.front();
+	LogInternal(JournalEvent::OrderCancelled, order);
 
-			if (best->GetOrderType() == OrderType::FillAndKill)
-			{
-				auto payload = CancelOrderPayload{ best->GetOrderId() };
-				CancelOrderInternal(payload);
-			}
-		};
+	orderPool_.Release(order);
+}
 
-	while (!bids_.empty() && !asks_.empty())
-	{
-		// Get the bid and ask levels by price priority
+template <typename Threading>
+void BasicOrderBook<Threading>::MatchOrdersInternal(OrderPointer order)
+{
+	if (order->GetSide() == Side::Buy) MatchOrdersKernel<Side::Buy>(order);
+	else MatchOrdersKernel<Side::Sell>(order);
+}
 
-		auto& [bidPrice, bidLevel] = *bids_.begin();
-		auto& [askPrice, askLevel] = *asks_.begin();
+template <typename Threading>
+template <Side S>
+void BasicOrderBook<Threading>::MatchOrdersKernel(OrderPointer order)
+{
+	// Sweep the opposite side from its best level while the order crosses it,
+	// the order itself is not on the book
+
+	constexpr Side Opposite = OppositeSide<S>;
+	auto& opposite = LevelsOf<Opposite>();
 
-		if (bidPrice < askPrice) break;
+	while (!order->IsFilled() && CanMatchKernel<S>(order->GetPrice()))
+	{
+		const Price levelPrice = opposite.BestPrice();
+		auto& level = opposite.BestLevel().orders_;
 
 		// Match orders by time priority
 
-		while (!bidLevel.empty() && !askLevel.empty())
+		while (!order->IsFilled() && !level.empty())
 		{
-			auto bid = bidLevel.front();
-			auto ask = askLevel.front();
+			auto resting = level.front();
 
-			Quantity quantity = std::min(bid->GetRemainingQuantity(), ask->GetRemainingQuantity());
-			bid->Fill(quantity);
-			ask->Fill(quantity);
+			Quantity quantity = std::min(order->GetRemainingQuantity(), resting->GetRemainingQuantity());
+			order->Fill(quantity);
+			resting->Fill(quantity);
 
-			if (bid->IsFilled()) removeOrder(bid, bidLevel);
-			if (ask->IsFilled()) removeOrder(ask, askLevel);
+			// Report the trade as a fill for each order, the bid first
 
-			// Record the trade
+			const auto& bid = (S == Side::Buy) ? order : resting;
+			const auto& ask = (S == Side::Buy) ? resting : order;
 
-			trades.emplace_back(Trade{
-				TradeInfo{ bid->GetOrderId(), bid->GetPrice(), quantity },
-				TradeInfo{ ask->GetOrderId(), ask->GetPrice(), quantity }
-				});
+			ReportFill(bid, ask, quantity);
+			ReportFill(ask, bid, quantity);
+
+			// Inline callers and waiting producers get the trade back as well
+
+			if (RecordsResult())
+			{
+				result_.trades_.emplace_back(
+					TradeInfo{ bid->GetOrderId(), bid->GetPrice(), quantity },
+					TradeInfo{ ask->GetOrderId(), ask->GetPrice(), quantity });
+			}
 
 			// Update the level infos struct
 
-			UpdateLevelOnMatchOrders(bid->GetPrice(), quantity, bid->IsFilled());
-			UpdateLevelOnMatchOrders(ask->GetPrice(), quantity, ask->IsFilled());
+			UpdateLevelsKernel<Opposite>(levelPrice, quantity,
+				resting->IsFilled() ? OrderEvent::CancelOrder : OrderEvent::MatchOrder);
+
+			// Filled orders are released last, once nothing reads from them
+
+			if (resting->IsFilled())
+			{
+				level.pop_front();
+				orders_.Erase(resting->GetOrderId());
+				orderPool_.Release(resting);
+			}
 		}
 
 		// Clear level if all orders have been filled
 
-		if (bidLevel.empty()) bids_.erase(bidPrice);
-		if (askLevel.empty()) asks_.erase(askPrice);
+		if (level.empty()) opposite.EraseLevel(levelPrice);
 	}
-
-	// Remove FAK order if could not be filled
-
-	if (!bids_.empty()) cancelFAK(bids_);
-	if (!asks_.empty()) cancelFAK(asks_);
-
-	return trades;
 }
 
-bool OrderBook::CanMatchInternal(Side side, Price price) const
+template <typename Threading>
+template <Side S>
+bool BasicOrderBook<Threading>::CanMatchKernel(Price price) const
 {
-	if (side == Side::Buy)
-		return !asks_.empty() && price >= asks_.begin()->first;
-	else
-		return !bids_.empty() && price <= bids_.begin()->first;
+	const auto& opposite = LevelsOf<OppositeSide<S>>();
+	if (opposite.Empty()) return false;
+
+	if constexpr (S == Side::Buy) return price >= opposite.BestPrice();
+	else return price <= opposite.BestPrice();
 }
 
 // Check if the quantity requested can be fulfilled by the aggregate
 // quantity available at crossed price levels on the opposite side
 
-bool OrderBook::CanBeFullyFilledInternal(Side side, Price price, Quantity quantity) const
+template <typename Threading>
+template <Side S>
+bool BasicOrderBook<Threading>::CanBeFullyFilledKernel(Price price, Quantity quantity) const
 {
-	if ((side == Side::Buy && asks_.empty()) ||
-		(side == Side::Sell && bids_.empty()) ||
-		!CanMatchInternal(side, price))
+	if (!CanMatchKernel<S>(price))
 		return false;
 
-	// Find the threshold price for executing an order
-	// E.g. If side is buy, threshold price is the lowest ask
-
-	Price bestPrice = (side == Side::Buy && !asks_.empty())
-		? asks_.begin()->first
-		: bids_.begin()->first;
-
-	// A level is valid if we can cross the orderbook
-
-	for (const auto& [levelPrice, levelDepth] : levels_)
-	{
-		// Skip levels which do not cross the orderbook
-
-		if ((side == Side::Buy && levelPrice < bestPrice) ||
-			(side == Side::Sell && levelPrice > bestPrice))
-			continue;
-
-		// Skip levels outside our range 
-		// I.e. above a buy price or below a sell price
-
-		if ((side == Side::Buy && levelPrice > price) ||
-			(side == Side::Sell && levelPrice < price))
-			continue;
-
-		// Check if level can fill completely, otherwise reduce remaining quantity
+	// Ask the opposite side for the quantity at or better than the price,
+	// e.g. the asks priced at or below a buy price
 
-		if (quantity <= levelDepth.quantity_)
-			return true;
-
-		quantity -= levelDepth.quantity_;
-	}
+	return LevelsOf<OppositeSide<S>>().CanFill(price, quantity);
+}
 
-	return false;
+template <typename Threading>
+void BasicOrderBook<Threading>::UpdateLevelsInternal(Side side, Price price, Quantity quantity, OrderEvent event)
+{
+	if (side == Side::Buy) UpdateLevelsKernel<Side::Buy>(price, quantity, event);
+	else UpdateLevelsKernel<Side::Sell>(price, quantity, event);
 }
 
-void OrderBook::UpdateLevelsInternal(Price price, Quantity quantity, OrderEvent event)
+template <typename Threading>
+template <Side S>
+void BasicOrderBook<Threading>::UpdateLevelsKernel(Price price, Quantity quantity, OrderEvent event)
 {
-	auto& levelDepth = levels_[price];
+	// The level exists throughout, it is only erased once its last order is taken off
+
+	auto& levels = LevelsOf<S>();
 
 	switch (event)
 	{
 	case OrderEvent::AddOrder:
-		levelDepth.quantity_ += quantity;
-		levelDepth.count_ += 1;
+		PublishDelta(S, price, levels.AddToLevel(price, quantity, 1));
 		break;
 	case OrderEvent::CancelOrder:
-		levelDepth.quantity_ -= quantity;
-		levelDepth.count_ -= 1;
+		PublishDelta(S, price, levels.RemoveFromLevel(price, quantity, 1));
 		break;
 	case OrderEvent::MatchOrder:
-		levelDepth.quantity_ -= quantity;
+	case OrderEvent::ReduceOrder:
+		PublishDelta(S, price, levels.RemoveFromLevel(price, quantity, 0));
 		break;
 	default:
-		break;
+		return;
 	}
 
-	if (levelDepth.count_ == 0) levels_.erase(price);
+	depthChanged_ = true;
 }
 
-void OrderBook::UpdateLevelOnAddOrder(OrderPointer order)
+template <typename Threading>
+void BasicOrderBook<Threading>::UpdateLevelOnAddOrder(OrderPointer order)
 {
 	UpdateLevelsInternal
 	(
+		order->GetSide(),
 		order->GetPrice(),
 		order->GetRemainingQuantity(),
 		OrderEvent::AddOrder
 	);
 }
 
-void OrderBook::UpdateLevelOnCancelOrder(OrderPointer order)
+template <typename Threading>
+void BasicOrderBook<Threading>::UpdateLevelOnCancelOrder(OrderPointer order)
 {
 	UpdateLevelsInternal
 	(
+		order->GetSide(),
 		order->GetPrice(),
 		order->GetRemainingQuantity(),
 		OrderEvent::CancelOrder
 	);
 }
 
-void OrderBook::UpdateLevelOnMatchOrders(Price price, Quantity quantity, bool isFullyFilled)
+template <typename Threading>
+void BasicOrderBook<Threading>::HandleEvent(const QueueEvent& event)
 {
-	UpdateLevelsInternal
-	(
-		price,
-		quantity,
-		isFullyFilled ? OrderEvent::CancelOrder : OrderEvent::MatchOrder
-	);
+	std::scoped_lock ordersLock{ ordersMutex_ };
+	HandleEventInternal(event);
 }
 
-void OrderBook::HandleEvent(const QueueEvent& event)
+template <typename Threading>
+void BasicOrderBook<Threading>::HandleEvents(std::span<const QueueEvent> events)
 {
 	std::scoped_lock ordersLock{ ordersMutex_ };
 
-	std::visit([this](auto&& payload)
-	{
-		using T = std::decay_t<decltype(payload)>;
-		if constexpr (std::is_same_v<T, AddOrderPayload>)
-			AddOrderInternal(payload);
-		else if constexpr (std::is_same_v<T, ModifyOrderPayload>)
-			ModifyOrderInternal(payload);
-		else if constexpr (std::is_same_v<T, CancelOrderPayload>)
-			CancelOrderInternal(payload);
-	}, event.payload_);
-}
\ No newline at end of file
+	for (const auto& event : events)
+		HandleEventInternal(event);
+}
+
+template <typename Threading>
+void BasicOrderBook<Threading>::HandleEventInternal(const QueueEvent& event)
+{
+#if defined(ORDERBOOK_LATENCY_TRACE)
+	const std::uint64_t startedAt = ReadTimestamp();
+	loggingTicks_ = 0;
+#endif
+
+	eventSequence_ = event.sequence_;
+	recordResult_ = event.producer_ != 0;
+
+	event.Visit([this](const auto& payload) { HandleRequestInternal(payload); });
+
+	if (recordResult_) CompleteRequestInternal(event);
+
+#if defined(ORDERBOOK_LATENCY_TRACE)
+	TraceEventInternal(startedAt, event.enqueuedAt_, event.dequeuedAt_);
+#endif
+}
+
+template <typename Threading>
+template <typename T>
+void BasicOrderBook<Threading>::HandleRequestInternal(const T& payload)
+{
+	if (RecordsResult())
+	{
+		result_.trades_.clear();
+		result_.rejectReason_ = RejectReason::None;
+	}
+
+	if constexpr (std::is_same_v<T, AddOrderPayload>)
+		AddOrderInternal(payload);
+	else if constexpr (std::is_same_v<T, ModifyOrderPayload>)
+		ModifyOrderInternal(payload);
+	else if constexpr (std::is_same_v<T, CancelOrderPayload>)
+		CancelOrderInternal(payload);
+
+	if (publishTopOfBook_ && depthChanged_) PublishTopOfBookInternal();
+}
+
+template <typename Threading>
+void BasicOrderBook<Threading>::CompleteRequestInternal(const QueueEvent& event)
+{
+	// Producers that were never registered are not acknowledged
+
+	auto* completions = event.producer_ < completionRings_.size() ? completionRings_[event.producer_] : nullptr;
+	if (!completions) return;
+
+	Completion completion
+	{
+		.ticket_ = event.sequence_,
+		.orderId_ = event.orderId_,
+		.fills_ = static_cast<std::uint32_t>(result_.trades_.size())
+	};
+
+	// Each trade filled the request's own order on one side
+
+	for (const auto& trade : result_.trades_)
+		completion.filledQuantity_ += trade.GetBidTrade().quantity_;
+
+	if (result_.IsRejected())
+	{
+		completion.status_ = CompletionStatus::Rejected;
+		completion.reason_ = result_.rejectReason_;
+	}
+	else if (event.event_ == EventType::CancelOrder || (event.event_ == EventType::ModifyOrder && event.quantity_ == 0))
+	{
+		completion.status_ = CompletionStatus::Cancelled;
+	}
+	else if (auto order = orders_.Find(event.orderId_))
+	{
+		completion.status_ = CompletionStatus::Rested;
+		completion.leavesQuantity_ = order->GetRemainingQuantity();
+	}
+	else
+	{
+		completion.status_ = completion.filledQuantity_ < event.quantity_ ? CompletionStatus::Killed : CompletionStatus::Filled;
+	}
+
+	completions->Push(completion);
+}
+
+#if defined(ORDERBOOK_LATENCY_TRACE)
+template <typename Threading>
+void BasicOrderBook<Threading>::TraceEventInternal(std::uint64_t startedAt, std::uint64_t enqueuedAt, std::uint64_t dequeuedAt)
+{
+	const std::uint64_t handledAt = ReadTimestamp();
+	const std::uint64_t handlingTicks = TimestampsBetween(startedAt, handledAt);
+
+	latencyTrace_.Record(LatencyStage::Match, handlingTicks - std::min(loggingTicks_, handlingTicks));
+	latencyTrace_.Record(LatencyStage::Logging, loggingTicks_);
+
+	// Requests handled inline or handed to HandleEvent directly never went through a queue
+
+	if (enqueuedAt == 0) return;
+
+	latencyTrace_.Record(LatencyStage::QueueWait, TimestampsBetween(enqueuedAt, dequeuedAt));
+	latencyTrace_.Record(LatencyStage::EndToEnd, TimestampsBetween(enqueuedAt, handledAt));
+}
+#endif
+
+template <typename Threading>
+void BasicOrderBook<Threading>::ReportFill(OrderPointer order, OrderPointer counterparty, Quantity quantity)
+{
+	if (!reportSink_) return;
+
+	reportSink_->Publish(ExecutionReport
+		{
+			.sequence_ = eventSequence_,
+			.orderId_ = order->GetOrderId(),
+			.counterpartyId_ = counterparty->GetOrderId(),
+			.symbolId_ = symbolId_,
+			.price_ = order->GetPrice(),
+			.quantity_ = quantity,
+			.leavesQuantity_ = order->GetRemainingQuantity(),
+			.type_ = ExecutionType::Fill,
+			.side_ = order->GetSide()
+		});
+}
+
+template <typename Threading>
+void BasicOrderBook<Threading>::ReportCancel(OrderPointer order)
+{
+	if (!reportSink_) return;
+
+	reportSink_->Publish(ExecutionReport
+		{
+			.sequence_ = eventSequence_,
+			.orderId_ = order->GetOrderId(),
+			.symbolId_ = symbolId_,
+			.price_ = order->GetPrice(),
+			.quantity_ = order->GetRemainingQuantity(),
+			.type_ = ExecutionType::Cancel,
+			.side_ = order->GetSide()
+		});
+}
+
+template <typename Threading>
+void BasicOrderBook<Threading>::ReportReject(OrderId orderId, Side side, Price price, Quantity quantity, RejectReason reason)
+{
+	if (RecordsResult()) result_.rejectReason_ = reason;
+
+	if (!reportSink_) return;
+
+	reportSink_->Publish(ExecutionReport
+		{
+			.sequence_ = eventSequence_,
+			.orderId_ = orderId,
+			.symbolId_ = symbolId_,
+			.price_ = price,
+			.quantity_ = quantity,
+			.type_ = ExecutionType::Reject,
+			.reason_ = reason,
+			.side_ = side
+		});
+}
+
+template <typename Threading>
+void BasicOrderBook<Threading>::LogInternal(JournalEvent event, OrderId orderId)
+{
+	LogInternal(JournalRecord{ .orderId_ = orderId, .event_ = event });
+}
+
+template <typename Threading>
+void BasicOrderBook<Threading>::LogInternal(JournalEvent event, OrderPointer order)
+{
+	LogInternal(JournalRecord
+		{
+			.orderId_ = order->GetOrderId(),
+			.price_ = order->GetPrice(),
+			.quantity_ = order->GetRemainingQuantity(),
+			.event_ = event,
+			.orderType_ = order->GetOrderType(),
+			.side_ = order->GetSide()
+		});
+}
+
+template <typename Threading>
+void BasicOrderBook<Threading>::LogInternal(JournalRecord record)
+{
+	if (replaying_ || !auditLog_) return;
+
+	record.timestamp_ = std::chrono::duration_cast<std::chrono::nanoseconds>(
+		std::chrono::system_clock::now().time_since_epoch()).count();
+	record.sequence_ = eventSequence_;
+	record.symbolId_ = symbolId_;
+
+	// Formatting is deferred to the decoder when journaling
+
+#if defined(ORDERBOOK_LATENCY_TRACE)
+	const std::uint64_t loggingStart = ReadTimestamp();
+#endif
+
+	if (journal_) journal_->Append(record);
+	else FileLogger::Get()->info(FormatJournalMessage(record));
+
+#if defined(ORDERBOOK_LATENCY_TRACE)
+	loggingTicks_ += TimestampsBetween(loggingStart, ReadTimestamp());
+#endif
+}
+
+template <typename Threading>
+void BasicOrderBook<Threading>::PublishDelta(Side side, Price price, const PriceLevel& level)
+{
+	if (!marketDataFeed_) return;
+
+	marketDataFeed_->Publish(LevelDelta
+		{
+			.sequence_ = ++deltaSequence_,
+			.symbolId_ = symbolId_,
+			.price_ = price,
+			.quantity_ = level.quantity_,
+			.count_ = level.count_,
+			.side_ = side
+		});
+}
+
+template <typename Threading>
+void BasicOrderBook<Threading>::PublishTopOfBookInternal()
+{
+	TopOfBook topOfBook{ .sequence_ = eventSequence_, .orders_ = orders_.Size() };
+
+	auto copyLevels = [](const PriceLevels& side, auto& levels, std::uint32_t& count)
+		{
+			// The visitor captures a single pointer so that it fits in the small buffer of
+			// std::function, publishing runs after every request and must not allocate
+
+			struct Target
+			{
+				std::remove_reference_t<decltype(levels)>& levels_;
+				std::uint32_t& count_;
+			} target{ levels, count };
+
+			side.ForEachBestLevel(levels.size(), [&target](Price price, const PriceLevel& level)
+				{ target.levels_[target.count_++] = DepthLevel{ price, level.quantity_, level.count_ }; });
+		};
+
+	copyLevels(*bids_, topOfBook.bids_, topOfBook.bidLevels_);
+	copyLevels(*asks_, topOfBook.asks_, topOfBook.askLevels_);
+
+	topOfBook_.Store(topOfBook);
+	depthChanged_ = false;
+}
+
+template class BasicOrderBook<QueuedThreading>;
+template class BasicOrderBook<InlineThreading>;
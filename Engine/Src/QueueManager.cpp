@@ -1,21 +1,54 @@
 #include "../Include/Queue/QueueManager.h"
 
-QueueManager::QueueManager(std::function<void(const QueueEvent&)> eventHandler)
-	: stopQueueManager_(false)
-	, eventHandler_(std::move(eventHandler))
+#include <algorithm>
+#include <stdexcept>
+
+#if defined(_WIN32)
+#define NOMINMAX
+#include <windows.h>
+#elif defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+namespace
 {
-	// Wait for worker thread handling events to start
-	
-	std::promise<void> readyPromise;
-	std::future<void> readyFuture = readyPromise.get_future();
+	// Number of spins before the SpinYield and Park strategies back off
+	constexpr std::size_t SpinLimit = 1'000;
 
-	workerThread_ = std::thread([this, promise = std::move(readyPromise)]() mutable
+	// Pins the thread to a single core, best effort on platforms without affinity
+	void PinToCore(std::thread& thread, int core)
 	{
-		promise.set_value();
-		HandleEvents();
-	});
+#if defined(_WIN32)
+		SetThreadAffinityMask(thread.native_handle(), DWORD_PTR{ 1 } << core);
+#elif defined(__linux__)
+		cpu_set_t cpus;
+		CPU_ZERO(&cpus);
+		CPU_SET(core, &cpus);
+		pthread_setaffinity_np(thread.native_handle(), sizeof(cpus), &cpus);
+#else
+		(void)thread;
+		(void)core;
+#endif
+	}
+}
+
+QueueManager::QueueManager(const QueueConfig& config)
+	: config_{ config }
+	, stopQueueManager_(false)
+{
+	config_.batchSize_ = std::max<std::size_t>(config_.batchSize_, 1);
 
-	readyFuture.wait();
+	if (config_.mode_ == QueueMode::Spsc)
+		ring_ = std::make_unique<SpscRing<QueueEvent>>(config_.capacity_);
+	else if (config_.mode_ == QueueMode::Mpsc)
+		mpscRing_ = std::make_unique<MpscRing<QueueEvent>>(config_.capacity_);
+}
+
+void QueueManager::PinWorker()
+{
+	if (config_.core_ >= 0)
+		PinToCore(workerThread_, config_.core_);
 }
 
 QueueManager::~QueueManager()
@@ -26,50 +59,217 @@ QueueManager::~QueueManager()
 	}
 
 	condition_.notify_all();
+	SignalWorker();
 	if (workerThread_.joinable()) workerThread_.join();
 }
 
-void QueueManager::EnqueueEvent(const QueueEvent& event)
+std::uint64_t QueueManager::EnqueueEvent(const QueueEvent& event)
 {
+	return EnqueueEvents(std::span<const QueueEvent>{ &event, 1 });
+}
+
+std::uint64_t QueueManager::EnqueueEvents(std::span<const QueueEvent> events)
+{
+	if (events.empty())
+		return LastEnqueued();
+
+	std::uint64_t sequence = 0;
+
+#if defined(ORDERBOOK_LATENCY_TRACE)
+	const std::uint64_t enqueuedAt = ReadTimestamp();
+#endif
+
+	if (config_.mode_ == QueueMode::Locked)
 	{
-		std::scoped_lock<std::mutex> lock(queueMutex_);
-		eventQueue_.push(event);
+		{
+			std::scoped_lock<std::mutex> lock(queueMutex_);
+			sequence = enqueued_.load(std::memory_order_relaxed);
+			for (const auto& event : events)
+			{
+				eventQueue_.push(event);
+				eventQueue_.back().sequence_ = ++sequence;
+#if defined(ORDERBOOK_LATENCY_TRACE)
+				eventQueue_.back().enqueuedAt_ = enqueuedAt;
+#endif
+			}
+			enqueued_.store(sequence, std::memory_order_release);
+		}
+		condition_.notify_one();
+		return sequence;
 	}
-	condition_.notify_one();
+
+	// Ring positions double as sequence numbers. An Mpsc batch claims consecutive
+	// positions, but may be split if the ring is nearly full
+
+	std::size_t written = 0;
+	std::size_t spins = 0;
+	const std::uint64_t base = ringSequenceBase_.load(std::memory_order_acquire);
+
+	auto writer = [&](QueueEvent& slot, std::uint64_t position)
+	{
+		slot = events[written++];
+		slot.sequence_ = sequence = base + position + 1;
+#if defined(ORDERBOOK_LATENCY_TRACE)
+		slot.enqueuedAt_ = enqueuedAt;
+#endif
+	};
+
+	while (written < events.size())
+	{
+		const std::size_t remaining = events.size() - written;
+		const std::size_t pushed = config_.mode_ == QueueMode::Spsc
+			? ring_->TryPushBatch(remaining, writer)
+			: mpscRing_->TryPushBatch(remaining, writer);
+
+		if (pushed == 0)
+		{
+			BackOff(spins);
+			continue;
+		}
+
+		// Wake the worker per chunk, not per batch, as it may park after draining
+		// the part of a batch that fit while the rest waits for room
+
+		if (config_.waitStrategy_ == WaitStrategy::Park)
+		{
+			// Pairs with the fence in IdleWorker so that either the worker sees the
+			// new events, or this thread sees the worker parked and wakes it
+
+			std::atomic_thread_fence(std::memory_order_seq_cst);
+			if (workerParked_.load(std::memory_order_relaxed))
+				SignalWorker();
+		}
+	}
+
+	return sequence;
 }
 
 void QueueManager::WaitForAllEvents() const
 {
-	std::unique_lock<std::mutex> lock(queueMutex_);
-	condition_.wait(lock, [this]() { return eventQueue_.empty(); });
+	// Wait on the sequence number rather than queue emptiness, so the event being
+	// processed when the queue drains is also waited for
+
+	const std::uint64_t target = LastEnqueued();
+
+	std::size_t spins = 0;
+	std::uint64_t processed;
+	while ((processed = processed_.load(std::memory_order_seq_cst)) < target)
+	{
+		if (config_.waitStrategy_ == WaitStrategy::BusySpin || ++spins < SpinLimit)
+		{
+			CpuRelax();
+		}
+		else if (config_.waitStrategy_ == WaitStrategy::SpinYield)
+		{
+			std::this_thread::yield();
+		}
+		else
+		{
+			waiters_.fetch_add(1, std::memory_order_seq_cst);
+			if (processed_.load(std::memory_order_seq_cst) == processed)
+				processed_.wait(processed, std::memory_order_seq_cst);
+			waiters_.fetch_sub(1, std::memory_order_relaxed);
+		}
+	}
+}
+
+bool QueueManager::Idle() const
+{
+	return processed_.load(std::memory_order_seq_cst) == LastEnqueued();
 }
 
-void QueueManager::HandleEvents()
+void QueueManager::ResumeFrom(std::uint64_t sequence)
 {
-	while (true)
-	{
-		// Fetch the next event from the queue
+	std::scoped_lock<std::mutex> lock(queueMutex_);
 
-		std::unique_lock<std::mutex> lock(queueMutex_);
-		condition_.wait(lock, [this]() { return stopQueueManager_ || !eventQueue_.empty(); });
+	if (!Idle())
+		throw std::logic_error("Only an idle queue can resume its numbering.");
 
-		if (stopQueueManager_ && eventQueue_.empty())
-			break;
+	const std::uint64_t last = LastEnqueued();
+	if (sequence <= last) return;
 
-		QueueEvent event = std::move(eventQueue_.front());
-		eventQueue_.pop();
-		lock.unlock();
+	if (config_.mode_ == QueueMode::Locked)
+		enqueued_.store(sequence, std::memory_order_release);
+	else
+		ringSequenceBase_.fetch_add(sequence - last, std::memory_order_release);
 
-		// Event is handled by the OrderBook
+	CompleteEvent(sequence);
+}
 
-		eventHandler_(event);
+void QueueManager::StampDequeued([[maybe_unused]] std::span<QueueEvent> events)
+{
+#if defined(ORDERBOOK_LATENCY_TRACE)
+	const std::uint64_t dequeuedAt = ReadTimestamp();
+	for (auto& event : events)
+		event.dequeuedAt_ = dequeuedAt;
+#endif
+}
 
-		// Notify waiting threads if queue is empty
+std::uint64_t QueueManager::LastEnqueued() const
+{
+	switch (config_.mode_)
+	{
+	case QueueMode::Spsc: return ringSequenceBase_.load(std::memory_order_acquire) + ring_->Claimed();
+	case QueueMode::Mpsc: return ringSequenceBase_.load(std::memory_order_acquire) + mpscRing_->Claimed();
+	default: return enqueued_.load(std::memory_order_acquire);
+	}
+}
 
+void QueueManager::BackOff(std::size_t& spins) const
+{
+	// The worker is draining the ring
+
+	if (config_.waitStrategy_ == WaitStrategy::BusySpin || ++spins < SpinLimit)
+		CpuRelax();
+	else
+		std::this_thread::yield();
+}
+
+void QueueManager::CompleteEvent(std::uint64_t sequence)
+{
+	processed_.store(sequence, std::memory_order_seq_cst);
+	if (waiters_.load(std::memory_order_seq_cst) > 0)
+		processed_.notify_all();
+}
+
+void QueueManager::IdleWorker(std::size_t& spins, std::uint64_t consumed)
+{
+	switch (config_.waitStrategy_)
+	{
+	case WaitStrategy::BusySpin:
+		CpuRelax();
+		break;
+	case WaitStrategy::SpinYield:
+		if (++spins < SpinLimit) CpuRelax();
+		else std::this_thread::yield();
+		break;
+	case WaitStrategy::Park:
+	{
+		if (++spins < SpinLimit)
 		{
-			std::lock_guard<std::mutex> lock(queueMutex_);
-			if (eventQueue_.empty())
-				condition_.notify_all();
+			CpuRelax();
+			break;
 		}
+
+		const auto signal = workerSignal_.load(std::memory_order_acquire);
+		workerParked_.store(true, std::memory_order_relaxed);
+		std::atomic_thread_fence(std::memory_order_seq_cst);
+
+		if (LastEnqueued() == consumed &&
+			!stopQueueManager_.load(std::memory_order_acquire))
+			workerSignal_.wait(signal, std::memory_order_acquire);
+
+		workerParked_.store(false, std::memory_order_relaxed);
+		spins = 0;
+		break;
+	}
+	default:
+		break;
 	}
-}
\ No newline at end of file
+}
+
+void QueueManager::SignalWorker()
+{
+	workerSignal_.fetch_add(1, std::memory_order_release);
+	workerSignal_.notify_one();
+}
@@ -0,0 +1,71 @@
+#include <chrono>
+#include <ctime>
+#include <format>
+#include <fstream>
+#include <iostream>
+
+#include "Include/Journal/JournalReader.h"
+
+// Renders a binary journal in the text format of the FileLogger,
+// e.g. "[2025-01-31 09:30:00] [info] 1: Order added successfully. Info: { ... }"
+
+namespace
+{
+	std::string FormatTimestamp(std::int64_t nanoseconds)
+	{
+		const auto time = static_cast<std::time_t>(nanoseconds / 1'000'000'000);
+
+		std::tm local{ };
+#if defined(_WIN32)
+		localtime_s(&local, &time);
+#else
+		localtime_r(&time, &local);
+#endif
+
+		return std::format("{:04}-{:02}-{:02} {:02}:{:02}:{:02}",
+			local.tm_year + 1900, local.tm_mon + 1, local.tm_mday,
+			local.tm_hour, local.tm_min, local.tm_sec);
+	}
+}
+
+int main(int argc, char* argv[])
+{
+	if (argc < 2 || argc > 3)
+	{
+		std::cerr << "Usage: JournalDecoder <journal path> [output file]\n"
+			<< "Decodes the segments <journal path>.000000, <journal path>.000001, ... to text.\n";
+		return 1;
+	}
+
+	try
+	{
+		JournalReader reader{ argv[1] };
+
+		std::ofstream file;
+		if (argc == 3) file.open(argv[2]);
+		std::ostream& output = (argc == 3) ? file : std::cout;
+
+		if (!output)
+		{
+			std::cerr << std::format("Cannot open {} for writing.\n", argv[2]);
+			return 1;
+		}
+
+		// Records are rendered one at a time straight from the mapped segments
+
+		reader.ForEachRecord([&output](const JournalRecord& record)
+			{
+				output << std::format("[{}] [info] {}\n",
+					FormatTimestamp(record.timestamp_), FormatJournalMessage(record));
+			});
+
+		std::cerr << std::format("Decoded {} records from {} segments.\n", reader.Size(), reader.SegmentCount());
+	}
+	catch (const std::exception& exception)
+	{
+		std::cerr << exception.what() << '\n';
+		return 1;
+	}
+
+	return 0;
+}
@@ -0,0 +1,372 @@
+#include <algorithm>
+#include <chrono>
+#include <deque>
+#include <format>
+#include <fstream>
+#include <iostream>
+#include <numeric>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "Include/OrderBook/OrderBook.h"
+#include "Include/Util/LatencyHistogram.h"
+#include "../Benchmark/Include/OrderGenerator.h"
+
+// Times single book operations against a resting book of 1K to 10M orders and
+// reports the p50, p99, p99.9 and max latency of each as JSON, e.g.
+// { "bookSize": 1000, "operation": "cancel_front", "samples": 10000, "p50": 95, ... }
+// Requests are handed to OrderBook::HandleEvent on the timing thread, so the times
+// cover the book lock and the matching path but not the request queue
+
+namespace
+{
+	using Clock = std::chrono::steady_clock;
+
+	// Bids rest at MidPrice - 1, MidPrice - 2, ... and asks at MidPrice + 1, ..., every
+	// order for OrderQuantity, so that the levels crossed by a request are known
+
+	constexpr Price MidPrice = 1'000;
+	constexpr Quantity OrderQuantity = 10;
+	constexpr std::size_t MaxLevelsPerSide = 900;
+	constexpr std::size_t OrdersPerLevel = 10;
+
+	constexpr std::size_t Samples = 10'000;
+	constexpr std::size_t SweepSamples = 100;
+
+	struct Result
+	{
+		std::string operation_;
+		std::size_t bookSize_;
+		std::uint64_t samples_;
+		std::uint64_t p50_;
+		std::uint64_t p99_;
+		std::uint64_t p999_;
+		std::uint64_t max_;
+	};
+
+	// A book of a given size, mirrored level by level in time priority so that the
+	// benchmark can pick the order at a given position and restore the book after
+	// each timed request
+
+	class RestingBook
+	{
+	public:
+
+		// Books keep no audit log, so that the timings cover the operation alone. Ids are
+		// handed out in sequence, the timed operations and the orders rested to restore
+		// the book take fewer than the book size plus 20 per sample
+
+		explicit RestingBook(std::size_t size)
+			: levelsPerSide_{ std::clamp<std::size_t>(size / (2 * OrdersPerLevel), 1, MaxLevelsPerSide) }
+			, book_{ OrderBookConfig
+				{
+					.levelStorage_ = LevelStorage::Ladder,
+					.orderIdMapMode_ = OrderIdMapMode::Direct,
+					.maxOrderId_ = static_cast<OrderId>(2 * size + 20 * Samples),
+					.reservedOrders_ = size + size / 2,
+					.auditLog_ = false
+				} }
+			, bids_(levelsPerSide_)
+			, asks_(levelsPerSide_)
+		{
+			for (std::size_t i = 0; i < size; ++i)
+				Rest(i % 2 == 0 ? Side::Buy : Side::Sell, i / 2 % levelsPerSide_);
+		}
+
+		std::size_t LevelsPerSide() const { return levelsPerSide_; }
+
+		static Price PriceOf(Side side, std::size_t level)
+		{
+			const auto offset = static_cast<Price>(level) + 1;
+			return side == Side::Buy ? MidPrice - offset : MidPrice + offset;
+		}
+
+		std::deque<OrderId>& Level(Side side, std::size_t level)
+		{
+			return side == Side::Buy ? bids_[level] : asks_[level];
+		}
+
+		OrderId NextId() { return nextId_++; }
+
+		void Handle(const QueueEvent& event) { book_.HandleEvent(event); }
+
+		void Time(LatencyHistogram& histogram, const QueueEvent& event)
+		{
+			const auto start = Clock::now();
+			book_.HandleEvent(event);
+			const auto end = Clock::now();
+
+			histogram.Record(static_cast<std::uint64_t>(
+				std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count()));
+		}
+
+		// Adds an order at the back of a mirrored level, untimed
+		void Rest(Side side, std::size_t level)
+		{
+			const OrderId id = NextId();
+			Handle(AddEvent(id, OrderType::GoodTillCancel, side, PriceOf(side, level), OrderQuantity));
+			Level(side, level).push_back(id);
+		}
+
+		static QueueEvent AddEvent(OrderId id, OrderType type, Side side, Price price, Quantity quantity)
+		{
+			return QueueEvent{ AddOrderPayload{ id, type, side, price, quantity } };
+		}
+
+		static QueueEvent ModifyEvent(OrderId id, Side side, Price price, Quantity quantity)
+		{
+			return QueueEvent{ ModifyOrderPayload{ id, side, price, quantity } };
+		}
+
+		static QueueEvent CancelEvent(OrderId id)
+		{
+			return QueueEvent{ CancelOrderPayload{ id } };
+		}
+
+	private:
+
+		std::size_t levelsPerSide_;
+		OrderId nextId_{ 1 };
+		OrderBook book_;
+		std::vector<std::deque<OrderId>> bids_;
+		std::vector<std::deque<OrderId>> asks_;
+	};
+
+	Result Summarize(std::string operation, std::size_t bookSize, const LatencyHistogram& histogram)
+	{
+		return Result
+		{
+			std::move(operation),
+			bookSize,
+			histogram.Count(),
+			histogram.ValueAtPercentile(50.0),
+			histogram.ValueAtPercentile(99.0),
+			histogram.ValueAtPercentile(99.9),
+			histogram.Max()
+		};
+	}
+
+	void BenchmarkBookSize(std::size_t bookSize, std::vector<Result>& results)
+	{
+		RestingBook book{ bookSize };
+
+		std::default_random_engine generator;
+		EventSampler sampler(DefaultParams(static_cast<int>(bookSize)));
+		std::uniform_int_distribution<std::size_t> levelDist(0, book.LevelsPerSide() - 1);
+		std::bernoulli_distribution sideDist(0.5);
+
+		auto randomSide = [&]() { return sideDist(generator) ? Side::Buy : Side::Sell; };
+		auto record = [&](std::string operation, const LatencyHistogram& histogram)
+			{ results.push_back(Summarize(std::move(operation), bookSize, histogram)); };
+
+		// Passive add at a price drawn from the benchmark parameters, kept off the
+		// other side, then cancelled
+
+		{
+			LatencyHistogram histogram;
+			for (std::size_t i = 0; i < Samples; ++i)
+			{
+				const auto event = sampler(generator);
+				const Price price = event.side_ == Side::Buy
+					? std::clamp<Price>(event.price_, 1, MidPrice)
+					: std::max<Price>(event.price_, MidPrice + 1);
+
+				const OrderId id = book.NextId();
+				book.Time(histogram, RestingBook::AddEvent(id, OrderType::GoodTillCancel, event.side_, price, event.quantity_));
+				book.Handle(RestingBook::CancelEvent(id));
+			}
+			record("passive_add", histogram);
+		}
+
+		// Add which fills the order at the front of the best opposite level exactly
+
+		{
+			LatencyHistogram histogram;
+			for (std::size_t i = 0; i < Samples; ++i)
+			{
+				const Side side = randomSide();
+				const Side opposite = side == Side::Buy ? Side::Sell : Side::Buy;
+
+				book.Time(histogram, RestingBook::AddEvent(book.NextId(), OrderType::GoodTillCancel,
+					side, RestingBook::PriceOf(opposite, 0), OrderQuantity));
+
+				book.Level(opposite, 0).pop_front();
+				book.Rest(opposite, 0);
+			}
+			record("crossing_add", histogram);
+		}
+
+		// Cancels at the front, middle and back of a level, each order then added again
+
+		for (const auto& [operation, position] : { std::pair{ "cancel_front", 0.0 },
+			std::pair{ "cancel_middle", 0.5 }, std::pair{ "cancel_back", 1.0 } })
+		{
+			LatencyHistogram histogram;
+			for (std::size_t i = 0; i < Samples; ++i)
+			{
+				const Side side = randomSide();
+				const std::size_t levelIndex = levelDist(generator);
+				auto& level = book.Level(side, levelIndex);
+
+				const auto it = level.begin() + static_cast<std::ptrdiff_t>(position * static_cast<double>(level.size() - 1));
+				book.Time(histogram, RestingBook::CancelEvent(*it));
+
+				level.erase(it);
+				book.Rest(side, levelIndex);
+			}
+			record(operation, histogram);
+		}
+
+		// Quantity reduction in place, restored by an increase which requeues the order
+
+		{
+			LatencyHistogram histogram;
+			for (std::size_t i = 0; i < Samples; ++i)
+			{
+				const Side side = randomSide();
+				const std::size_t levelIndex = levelDist(generator);
+				auto& level = book.Level(side, levelIndex);
+				const auto it = level.begin() + static_cast<std::ptrdiff_t>(generator() % level.size());
+				const OrderId id = *it;
+				const Price price = RestingBook::PriceOf(side, levelIndex);
+
+				book.Time(histogram, RestingBook::ModifyEvent(id, side, price, OrderQuantity - 1));
+				book.Handle(RestingBook::ModifyEvent(id, side, price, OrderQuantity));
+
+				level.erase(it);
+				level.push_back(id);
+			}
+			record("modify_reduce", histogram);
+		}
+
+		// Price change moving an order to the back of another level on its side
+
+		{
+			LatencyHistogram histogram;
+			for (std::size_t i = 0; i < Samples; ++i)
+			{
+				const Side side = randomSide();
+				const std::size_t from = levelDist(generator);
+				const std::size_t to = levelDist(generator);
+				auto& level = book.Level(side, from);
+				const OrderId id = level.front();
+
+				book.Time(histogram, RestingBook::ModifyEvent(id, side, RestingBook::PriceOf(side, to), OrderQuantity));
+
+				level.pop_front();
+				book.Level(side, to).push_back(id);
+
+				// Keep every level populated
+
+				if (level.empty()) book.Rest(side, from);
+			}
+			record("modify_move", histogram);
+		}
+
+		// Fill-or-kill checks across k levels, one lot short of filling so that the
+		// book is left untouched
+
+		for (std::size_t depth : { 1, 10, 100 })
+		{
+			if (depth > book.LevelsPerSide()) break;
+
+			LatencyHistogram histogram;
+			for (std::size_t i = 0; i < Samples; ++i)
+			{
+				const Side side = randomSide();
+				const Side opposite = side == Side::Buy ? Side::Sell : Side::Buy;
+
+				std::size_t orders = 0;
+				for (std::size_t level = 0; level < depth; ++level)
+					orders += book.Level(opposite, level).size();
+
+				book.Time(histogram, RestingBook::AddEvent(book.NextId(), OrderType::FillOrKill, side,
+					RestingBook::PriceOf(opposite, depth - 1), static_cast<Quantity>(orders) * OrderQuantity + 1));
+			}
+			record(std::format("fok_check_{}", depth), histogram);
+		}
+
+		// Market orders sweeping exactly k levels, which are then rebuilt
+
+		for (std::size_t depth : { 1, 10 })
+		{
+			if (depth > book.LevelsPerSide()) break;
+
+			LatencyHistogram histogram;
+			for (std::size_t i = 0; i < SweepSamples; ++i)
+			{
+				const Side side = randomSide();
+				const Side opposite = side == Side::Buy ? Side::Sell : Side::Buy;
+
+				std::vector<std::size_t> sizes;
+				for (std::size_t level = 0; level < depth; ++level)
+					sizes.push_back(book.Level(opposite, level).size());
+
+				const auto orders = std::accumulate(sizes.begin(), sizes.end(), std::size_t{ 0 });
+				book.Time(histogram, RestingBook::AddEvent(book.NextId(), OrderType::Market, side, 0,
+					static_cast<Quantity>(orders) * OrderQuantity));
+
+				for (std::size_t level = 0; level < depth; ++level)
+				{
+					book.Level(opposite, level).clear();
+					for (std::size_t order = 0; order < sizes[level]; ++order)
+						book.Rest(opposite, level);
+				}
+			}
+			record(std::format("market_sweep_{}", depth), histogram);
+		}
+	}
+
+	std::string ToJson(const std::vector<Result>& results)
+	{
+		std::string json = "[\n";
+		for (std::size_t i = 0; i < results.size(); ++i)
+		{
+			const auto& result = results[i];
+			json += std::format("  {{ \"bookSize\": {}, \"operation\": \"{}\", \"samples\": {}, "
+				"\"p50\": {}, \"p99\": {}, \"p999\": {}, \"max\": {} }}{}\n",
+				result.bookSize_, result.operation_, result.samples_,
+				result.p50_, result.p99_, result.p999_, result.max_,
+				i + 1 < results.size() ? "," : "");
+		}
+		return json + "]\n";
+	}
+}
+
+int main(int argc, char* argv[])
+{
+	if (argc > 3)
+	{
+		std::cerr << "Usage: MicroBenchmark [output file] [largest book size]\n"
+			<< "Writes per-operation latency percentiles in nanoseconds as JSON.\n";
+		return 1;
+	}
+
+	const std::size_t largest = (argc == 3) ? std::stoull(argv[2]) : 10'000'000;
+
+	std::vector<Result> results;
+	for (std::size_t bookSize = 1'000; bookSize <= largest; bookSize *= 10)
+	{
+		std::cerr << std::format("Timing operations on a book of {} orders...\n", bookSize);
+		BenchmarkBookSize(bookSize, results);
+	}
+
+	const auto json = ToJson(results);
+	if (argc >= 2)
+	{
+		std::ofstream output{ argv[1] };
+		if (!output)
+		{
+			std::cerr << std::format("Cannot open {} for writing.\n", argv[1]);
+			return 1;
+		}
+		output << json;
+	}
+	else
+	{
+		std::cout << json;
+	}
+
+	return 0;
+}
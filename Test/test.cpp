@@ -1,10 +1,16 @@
 #include "pch.h"
 #include "Include/Orderbook/OrderBook.h"
+#include "Include/Orderbook/PriceMap.h"
+#include "Include/Orderbook/PriceLadder.h"
+#include "Include/Exchange/Exchange.h"
+#include "Include/Journal/JournalReader.h"
 #include "Include/Util/InputHandler.h"
+#include "Include/Util/EventFileParser.h"
+#include "Include/Util/LatencyHistogram.h"
 
 namespace googletest = ::testing;
 
-class OrderBookTestsFixture : public googletest::TestWithParam<const char*>
+class OrderBookTestsFixture : public googletest::TestWithParam<std::tuple<const char*, LevelStorage, OrderIdMapMode, QueueMode, bool>>
 {
 private:
 
@@ -17,46 +23,123 @@ public:
 
 };
 
+const std::vector<const char*> TestFiles
+{
+	"Match_GoodTillCancel.txt",
+	"Match_FillAndKill.txt",
+	"Match_FillOrKill_Hit.txt",
+	"Match_FillOrKill_Miss.txt",
+	"Cancel_Success.txt",
+	"Modify_Side.txt",
+	"Match_Market.txt",
+	"Match_OutsideLadder.txt",
+	"Match_FillOrKill_Depth.txt"
+};
 
 TEST_P(OrderBookTestsFixture, OrderbookTestSuite)
 {
-	const auto file = OrderBookTestsFixture::TestFolderPath / GetParam();
+	const auto& [fileName, levelStorage, orderIdMapMode, queueMode, batched] = GetParam();
+	const auto file = OrderBookTestsFixture::TestFolderPath / fileName;
 
 	InputHandler handler;
 	const auto [events, result] = handler.GetEventInformationsFromFile(file);
 
 	// Sequentially process order requests from the file
 
-	OrderBook orderbook;
+	OrderBook orderbook{ OrderBookConfig
+		{
+			.levelStorage_ = levelStorage,
+			.orderIdMapMode_ = orderIdMapMode,
+			.queue_ = { .mode_ = queueMode }
+		} };
+
+	if (batched)
+	{
+		std::vector<QueueEvent> batch;
+		for (const auto& info : events)
+			batch.push_back(ToQueueEvent(info));
+
+		orderbook.SubmitBatch(batch);
+	}
+	else
+	{
+		for (const auto& info : events)
+		{
+			switch (info.eventType_)
+			{
+				case EventType::AddOrder:
+					orderbook.AddOrderToQueue
+					(
+						info.orderId_,
+						info.orderType_,
+						info.side_,
+						info.price_,
+						info.quantity_
+					);
+					break;
+				case EventType::ModifyOrder:
+					orderbook.ModifyOrderToQueue
+					(
+						info.orderId_,
+						info.side_,
+						info.price_,
+						info.quantity_
+					);
+					break;
+				case EventType::CancelOrder:
+					orderbook.CancelOrderToQueue
+					(
+						info.orderId_
+					);
+					break;
+				default:
+					throw std::logic_error("Unsupported event.");
+			}
+		}
+	}
+
+	// Assert
+
+	const auto& orderbookInfos = orderbook.GetOrderInfos();
+	ASSERT_EQ(orderbook.Size(), result.allCount_);
+	ASSERT_EQ(orderbookInfos.GetBids().size(), result.bidCount_);
+	ASSERT_EQ(orderbookInfos.GetAsks().size(), result.askCount_);
+}
+
+INSTANTIATE_TEST_CASE_P(Tests, OrderBookTestsFixture, googletest::Combine(
+	googletest::ValuesIn(TestFiles),
+	googletest::Values(LevelStorage::Map, LevelStorage::Ladder),
+	googletest::Values(OrderIdMapMode::Hashed, OrderIdMapMode::Direct),
+	googletest::Values(QueueMode::Locked, QueueMode::Spsc, QueueMode::Mpsc),
+	googletest::Bool()));
+
+class InlineOrderBookTestsFixture : public googletest::TestWithParam<std::tuple<const char*, LevelStorage>>
+{ };
+
+TEST_P(InlineOrderBookTestsFixture, InlineOrderbookTestSuite)
+{
+	const auto& [fileName, levelStorage] = GetParam();
+	const auto file = OrderBookTestsFixture::TestFolderPath / fileName;
+
+	InputHandler handler;
+	const auto [events, result] = handler.GetEventInformationsFromFile(file);
+
+	// Each request is handled on this thread before the call returns
+
+	InlineOrderBook orderbook{ OrderBookConfig{ .levelStorage_ = levelStorage } };
 
 	for (const auto& info : events)
 	{
 		switch (info.eventType_)
 		{
 			case EventType::AddOrder:
-				orderbook.AddOrderToQueue
-				(
-					info.orderId_,
-					info.orderType_,
-					info.side_,
-					info.price_,
-					info.quantity_
-				);
+				orderbook.AddOrder(info.orderId_, info.orderType_, info.side_, info.price_, info.quantity_);
 				break;
 			case EventType::ModifyOrder:
-				orderbook.ModifyOrderToQueue
-				(
-					info.orderId_,
-					info.side_,
-					info.price_,
-					info.quantity_
-				);
+				orderbook.ModifyOrder(info.orderId_, info.side_, info.price_, info.quantity_);
 				break;
 			case EventType::CancelOrder:
-				orderbook.CancelOrderToQueue
-				(
-					info.orderId_
-				);
+				orderbook.CancelOrder(info.orderId_);
 				break;
 			default:
 				throw std::logic_error("Unsupported event.");
@@ -71,12 +154,1038 @@ TEST_P(OrderBookTestsFixture, OrderbookTestSuite)
 	ASSERT_EQ(orderbookInfos.GetAsks().size(), result.askCount_);
 }
 
-INSTANTIATE_TEST_CASE_P(Tests, OrderBookTestsFixture, googletest::ValuesIn({
-	"Match_GoodTillCancel.txt",
-	"Match_FillAndKill.txt",
-	"Match_FillOrKill_Hit.txt",
-	"Match_FillOrKill_Miss.txt",
-	"Cancel_Success.txt",
-	"Modify_Side.txt",
-	"Match_Market.txt"
-}));
\ No newline at end of file
+INSTANTIATE_TEST_CASE_P(Tests, InlineOrderBookTestsFixture, googletest::Combine(
+	googletest::ValuesIn(TestFiles),
+	googletest::Values(LevelStorage::Map, LevelStorage::Ladder)));
+
+class ExchangeTestsFixture : public googletest::TestWithParam<std::tuple<const char*, QueueMode>>
+{ };
+
+TEST_P(ExchangeTestsFixture, ExchangeTestSuite)
+{
+	const auto& [fileName, queueMode] = GetParam();
+	const auto file = OrderBookTestsFixture::TestFolderPath / fileName;
+
+	InputHandler handler;
+	const auto [events, result] = handler.GetEventInformationsFromFile(file);
+
+	// Replay the file on several symbols sharded over two matching threads, with
+	// the symbols' events interleaved
+
+	constexpr SymbolId SymbolCount = 3;
+
+	Exchange exchange{ ExchangeConfig
+		{
+			.matchingThreads_ = 2,
+			.book_ = { .levelStorage_ = LevelStorage::Ladder, .queue_ = { .mode_ = queueMode } }
+		} };
+
+	for (SymbolId symbol = 0; symbol < SymbolCount; ++symbol)
+		exchange.AddSymbol(symbol);
+
+	std::vector<QueueEvent> batch;
+	for (const auto& info : events)
+	{
+		for (SymbolId symbol = 0; symbol < SymbolCount; ++symbol)
+		{
+			batch.push_back(ToQueueEvent(info));
+			batch.back().symbolId_ = symbol;
+		}
+	}
+
+	exchange.SubmitBatch(batch);
+	exchange.WaitForAllEvents();
+
+	// Assert
+
+	for (SymbolId symbol = 0; symbol < SymbolCount; ++symbol)
+	{
+		const auto& orderbook = exchange.GetBook(symbol);
+		const auto& orderbookInfos = orderbook.GetOrderInfos();
+		ASSERT_EQ(orderbook.Size(), result.allCount_);
+		ASSERT_EQ(orderbookInfos.GetBids().size(), result.bidCount_);
+		ASSERT_EQ(orderbookInfos.GetAsks().size(), result.askCount_);
+	}
+}
+
+INSTANTIATE_TEST_CASE_P(Tests, ExchangeTestsFixture, googletest::Combine(
+	googletest::ValuesIn(TestFiles),
+	googletest::Values(QueueMode::Locked, QueueMode::Mpsc)));
+
+TEST(ExecutionReportTests, ReportsFillsCancelsAndRejects)
+{
+	std::vector<ExecutionReport> reports;
+	ExecutionReportSink sink{ [&reports](std::span<const ExecutionReport> batch)
+		{ reports.insert(reports.end(), batch.begin(), batch.end()); } };
+
+	OrderBook orderbook{ OrderBookConfig{ .symbolId_ = 7, .reportSink_ = &sink } };
+
+	orderbook.AddOrderToQueue(1, OrderType::GoodTillCancel, Side::Buy, 100, 10);
+	orderbook.AddOrderToQueue(1, OrderType::GoodTillCancel, Side::Buy, 100, 10);
+	orderbook.AddOrderToQueue(2, OrderType::FillAndKill, Side::Sell, 110, 5);
+	orderbook.AddOrderToQueue(3, OrderType::FillOrKill, Side::Sell, 100, 20);
+	orderbook.AddOrderToQueue(4, OrderType::GoodTillCancel, Side::Sell, 100, 4);
+	orderbook.CancelOrderToQueue(1);
+	orderbook.CancelOrderToQueue(9);
+
+	orderbook.Size();
+	sink.Flush();
+
+	// Assert
+
+	struct Expected
+	{
+		ExecutionType type_;
+		OrderId orderId_;
+		RejectReason reason_;
+		Quantity quantity_;
+		Quantity leavesQuantity_;
+		std::uint64_t sequence_;
+	};
+
+	const std::vector<Expected> expected
+	{
+		{ ExecutionType::Reject, 1, RejectReason::DuplicateOrderId, 10, 0, 2 },
+		{ ExecutionType::Reject, 2, RejectReason::FillAndKillMiss, 5, 0, 3 },
+		{ ExecutionType::Reject, 3, RejectReason::FillOrKillMiss, 20, 0, 4 },
+		{ ExecutionType::Fill, 1, RejectReason::None, 4, 6, 5 },
+		{ ExecutionType::Fill, 4, RejectReason::None, 4, 0, 5 },
+		{ ExecutionType::Cancel, 1, RejectReason::None, 6, 0, 6 },
+		{ ExecutionType::Reject, 9, RejectReason::OrderNotFound, 0, 0, 7 },
+	};
+
+	ASSERT_EQ(reports.size(), expected.size());
+	for (std::size_t i = 0; i < expected.size(); ++i)
+	{
+		EXPECT_EQ(reports[i].type_, expected[i].type_);
+		EXPECT_EQ(reports[i].orderId_, expected[i].orderId_);
+		EXPECT_EQ(reports[i].reason_, expected[i].reason_);
+		EXPECT_EQ(reports[i].quantity_, expected[i].quantity_);
+		EXPECT_EQ(reports[i].leavesQuantity_, expected[i].leavesQuantity_);
+		EXPECT_EQ(reports[i].sequence_, expected[i].sequence_);
+		EXPECT_EQ(reports[i].symbolId_, 7u);
+	}
+
+	EXPECT_EQ(reports[3].counterpartyId_, 4u);
+	EXPECT_EQ(reports[4].counterpartyId_, 1u);
+}
+
+TEST(InlineOrderBookTests, ReturnsTradesAndRejectsToTheCaller)
+{
+	std::vector<ExecutionReport> reports;
+	ExecutionReportSink sink{ [&reports](std::span<const ExecutionReport> batch)
+		{ reports.insert(reports.end(), batch.begin(), batch.end()); } };
+
+	InlineOrderBook orderbook{ OrderBookConfig{ .reportSink_ = &sink } };
+
+	EXPECT_FALSE(orderbook.AddOrder(1, OrderType::GoodTillCancel, Side::Buy, 100, 10).IsRejected());
+	EXPECT_FALSE(orderbook.AddOrder(2, OrderType::GoodTillCancel, Side::Buy, 101, 5).IsRejected());
+	EXPECT_EQ(orderbook.AddOrder(1, OrderType::GoodTillCancel, Side::Buy, 100, 10).rejectReason_, RejectReason::DuplicateOrderId);
+	EXPECT_EQ(orderbook.AddOrder(3, OrderType::FillOrKill, Side::Sell, 100, 20).rejectReason_, RejectReason::FillOrKillMiss);
+
+	// A sell sweeping both bids trades with the best first
+
+	const auto& result = orderbook.AddOrder(4, OrderType::GoodTillCancel, Side::Sell, 100, 8);
+
+	EXPECT_FALSE(result.IsRejected());
+	ASSERT_EQ(result.trades_.size(), 2u);
+	EXPECT_EQ(result.trades_[0].GetBidTrade().orderId_, 2u);
+	EXPECT_EQ(result.trades_[0].GetBidTrade().price_, 101);
+	EXPECT_EQ(result.trades_[0].GetAskTrade().orderId_, 4u);
+	EXPECT_EQ(result.trades_[0].GetAskTrade().quantity_, 5u);
+	EXPECT_EQ(result.trades_[1].GetBidTrade().orderId_, 1u);
+	EXPECT_EQ(result.trades_[1].GetAskTrade().quantity_, 3u);
+
+	// The result is cleared by the next request
+
+	EXPECT_TRUE(orderbook.CancelOrder(1).trades_.empty());
+	EXPECT_EQ(orderbook.CancelOrder(1).rejectReason_, RejectReason::OrderNotFound);
+	EXPECT_EQ(orderbook.ModifyOrder(9, Side::Buy, 100, 1).rejectReason_, RejectReason::OrderNotFound);
+	EXPECT_EQ(orderbook.Size(), 0u);
+
+	// Reports are still published, numbered as if the requests had been queued
+
+	sink.Flush();
+	ASSERT_FALSE(reports.empty());
+	EXPECT_EQ(reports.front().sequence_, 3u);
+	EXPECT_EQ(reports.back().sequence_, 8u);
+}
+
+TEST(InlineOrderBookTests, RejectsDirectIdsBeyondTheLargestOrderId)
+{
+	std::vector<ExecutionReport> reports;
+	ExecutionReportSink sink{ [&reports](std::span<const ExecutionReport> batch)
+		{ reports.insert(reports.end(), batch.begin(), batch.end()); } };
+
+	InlineOrderBook orderbook{ OrderBookConfig
+		{
+			.orderIdMapMode_ = OrderIdMapMode::Direct,
+			.maxOrderId_ = 100,
+			.reportSink_ = &sink
+		} };
+
+	EXPECT_FALSE(orderbook.AddOrder(100, OrderType::GoodTillCancel, Side::Buy, 100, 10).IsRejected());
+	EXPECT_EQ(orderbook.AddOrder(101, OrderType::GoodTillCancel, Side::Buy, 100, 10).rejectReason_, RejectReason::OrderIdOutOfRange);
+	EXPECT_EQ(orderbook.AddOrder(std::numeric_limits<OrderId>::max(), OrderType::Market, Side::Sell, 0, 5).rejectReason_,
+		RejectReason::OrderIdOutOfRange);
+
+	// Rejected ids never reach the book, so they cannot be amended or cancelled
+
+	EXPECT_EQ(orderbook.CancelOrder(101).rejectReason_, RejectReason::OrderNotFound);
+	EXPECT_EQ(orderbook.Size(), 1u);
+
+	sink.Flush();
+	ASSERT_EQ(reports.size(), 3u);
+	EXPECT_EQ(reports[0].type_, ExecutionType::Reject);
+	EXPECT_EQ(reports[0].orderId_, 101u);
+	EXPECT_EQ(reports[0].reason_, RejectReason::OrderIdOutOfRange);
+	EXPECT_EQ(reports[1].reason_, RejectReason::OrderIdOutOfRange);
+}
+
+TEST(CompletionTests, AcknowledgesQueuedRequestsOnTheirProducersRing)
+{
+	OrderBook orderbook;
+	CompletionRing completions;
+	const auto producer = orderbook.AddProducer(completions);
+
+	std::vector<Ticket> tickets;
+	tickets.push_back(orderbook.AddOrderToQueue(1, OrderType::GoodTillCancel, Side::Buy, 100, 10, producer));
+	tickets.push_back(orderbook.AddOrderToQueue(1, OrderType::GoodTillCancel, Side::Buy, 100, 10, producer));
+	tickets.push_back(orderbook.AddOrderToQueue(2, OrderType::FillAndKill, Side::Sell, 100, 15, producer));
+
+	// Requests queued under no producer are not acknowledged
+
+	orderbook.AddOrderToQueue(3, OrderType::GoodTillCancel, Side::Buy, 99, 4);
+
+	tickets.push_back(orderbook.AddOrderToQueue(4, OrderType::GoodTillCancel, Side::Sell, 99, 6, producer));
+	tickets.push_back(orderbook.ModifyOrderToQueue(4, Side::Sell, 101, 6, producer));
+	tickets.push_back(orderbook.CancelOrderToQueue(4, producer));
+	tickets.push_back(orderbook.CancelOrderToQueue(4, producer));
+
+	EXPECT_EQ(orderbook.Size(), 0u);
+
+	std::array<Completion, 16> taken{ };
+	const auto count = completions.Poll(taken);
+
+	ASSERT_EQ(count, tickets.size());
+	for (std::size_t i = 0; i < count; ++i) EXPECT_EQ(taken[i].ticket_, tickets[i]);
+
+	EXPECT_EQ(taken[0].status_, CompletionStatus::Rested);
+	EXPECT_EQ(taken[0].leavesQuantity_, 10u);
+	EXPECT_EQ(taken[1].status_, CompletionStatus::Rejected);
+	EXPECT_EQ(taken[1].reason_, RejectReason::DuplicateOrderId);
+
+	// The fill-and-kill takes the resting bid and the rest of it is killed
+
+	EXPECT_EQ(taken[2].status_, CompletionStatus::Killed);
+	EXPECT_EQ(taken[2].filledQuantity_, 10u);
+	EXPECT_EQ(taken[2].fills_, 1u);
+
+	// The sell fills the bid of order 3 and rests the remainder, which is then moved
+	// and cancelled
+
+	EXPECT_EQ(taken[3].status_, CompletionStatus::Rested);
+	EXPECT_EQ(taken[3].filledQuantity_, 4u);
+	EXPECT_EQ(taken[3].leavesQuantity_, 2u);
+	EXPECT_EQ(taken[4].status_, CompletionStatus::Rested);
+	EXPECT_EQ(taken[5].status_, CompletionStatus::Cancelled);
+	EXPECT_EQ(taken[6].status_, CompletionStatus::Rejected);
+	EXPECT_EQ(taken[6].reason_, RejectReason::OrderNotFound);
+
+	EXPECT_EQ(completions.Poll(taken), 0u);
+}
+
+TEST(AmendTests, ReductionKeepsPriorityAndOtherAmendsLoseIt)
+{
+	std::vector<ExecutionReport> reports;
+	ExecutionReportSink sink{ [&reports](std::span<const ExecutionReport> batch)
+		{ reports.insert(reports.end(), batch.begin(), batch.end()); } };
+
+	OrderBook orderbook{ OrderBookConfig{ .reportSink_ = &sink } };
+
+	orderbook.AddOrderToQueue(1, OrderType::GoodTillCancel, Side::Buy, 100, 10);
+	orderbook.AddOrderToQueue(2, OrderType::GoodTillCancel, Side::Buy, 100, 10);
+	orderbook.ModifyOrderToQueue(1, Side::Buy, 100, 4);
+	orderbook.AddOrderToQueue(3, OrderType::GoodTillCancel, Side::Sell, 100, 5);
+	orderbook.AddOrderToQueue(4, OrderType::GoodTillCancel, Side::Buy, 100, 5);
+	orderbook.ModifyOrderToQueue(2, Side::Buy, 100, 12);
+	orderbook.AddOrderToQueue(5, OrderType::GoodTillCancel, Side::Sell, 100, 6);
+	orderbook.ModifyOrderToQueue(2, Side::Sell, 101, 3);
+
+	const auto infos = orderbook.GetOrderInfos();
+	sink.Flush();
+
+	// Assert
+
+	struct Expected
+	{
+		OrderId orderId_;
+		OrderId counterpartyId_;
+		Quantity quantity_;
+		Quantity leavesQuantity_;
+	};
+
+	// Order 1 kept its place ahead of order 2, which then queued behind order 4
+
+	const std::vector<Expected> expected
+	{
+		{ 1, 3, 4, 0 },
+		{ 3, 1, 4, 1 },
+		{ 2, 3, 1, 9 },
+		{ 3, 2, 1, 0 },
+		{ 4, 5, 5, 0 },
+		{ 5, 4, 5, 1 },
+		{ 2, 5, 1, 11 },
+		{ 5, 2, 1, 0 },
+	};
+
+	ASSERT_EQ(reports.size(), expected.size());
+	for (std::size_t i = 0; i < expected.size(); ++i)
+	{
+		EXPECT_EQ(reports[i].type_, ExecutionType::Fill);
+		EXPECT_EQ(reports[i].orderId_, expected[i].orderId_);
+		EXPECT_EQ(reports[i].counterpartyId_, expected[i].counterpartyId_);
+		EXPECT_EQ(reports[i].quantity_, expected[i].quantity_);
+		EXPECT_EQ(reports[i].leavesQuantity_, expected[i].leavesQuantity_);
+	}
+
+	EXPECT_EQ(orderbook.Size(), 1u);
+	EXPECT_TRUE(infos.GetBids().empty());
+	ASSERT_EQ(infos.GetAsks().size(), 1u);
+	EXPECT_EQ(infos.GetAsks()[0].price_, 101);
+	EXPECT_EQ(infos.GetAsks()[0].quantity_, 3u);
+}
+
+TEST(AmendTests, ZeroQuantityCancelsAndUnchangedAmendIsANoOp)
+{
+	std::vector<ExecutionReport> reports;
+	ExecutionReportSink sink{ [&reports](std::span<const ExecutionReport> batch)
+		{ reports.insert(reports.end(), batch.begin(), batch.end()); } };
+
+	std::vector<LevelDelta> deltas;
+	MarketDataFeed feed{ [&deltas](std::span<const LevelDelta> batch)
+		{ deltas.insert(deltas.end(), batch.begin(), batch.end()); } };
+
+	OrderBook orderbook{ OrderBookConfig{ .reportSink_ = &sink, .marketDataFeed_ = &feed } };
+	CompletionRing completions;
+	const auto producer = orderbook.AddProducer(completions);
+
+	orderbook.AddOrderToQueue(1, OrderType::GoodTillCancel, Side::Buy, 100, 10);
+	orderbook.AddOrderToQueue(2, OrderType::GoodTillCancel, Side::Buy, 100, 10);
+	orderbook.AddOrderToQueue(4, OrderType::GoodTillCancel, Side::Buy, 100, 5);
+	orderbook.ModifyOrderToQueue(1, Side::Buy, 100, 10, producer);
+	orderbook.ModifyOrderToQueue(2, Side::Buy, 100, 0, producer);
+	orderbook.AddOrderToQueue(3, OrderType::GoodTillCancel, Side::Sell, 100, 4);
+
+	EXPECT_EQ(orderbook.Size(), 2u);
+	sink.Flush();
+	feed.Flush();
+
+	// Assert
+
+	std::array<Completion, 4> taken{ };
+	ASSERT_EQ(completions.Poll(taken), 2u);
+	EXPECT_EQ(taken[0].status_, CompletionStatus::Rested);
+	EXPECT_EQ(taken[0].leavesQuantity_, 10u);
+	EXPECT_EQ(taken[1].status_, CompletionStatus::Cancelled);
+
+	// Order 2 is reported cancelled, order 1 kept its place at the front of the level
+
+	ASSERT_EQ(reports.size(), 3u);
+	EXPECT_EQ(reports[0].type_, ExecutionType::Cancel);
+	EXPECT_EQ(reports[0].orderId_, 2u);
+	EXPECT_EQ(reports[0].quantity_, 10u);
+	EXPECT_EQ(reports[1].type_, ExecutionType::Fill);
+	EXPECT_EQ(reports[1].orderId_, 1u);
+	EXPECT_EQ(reports[1].leavesQuantity_, 6u);
+
+	// The unchanged amend publishes nothing, the cancel takes order 2 off its level
+
+	ASSERT_EQ(deltas.size(), 5u);
+	EXPECT_EQ(deltas[3].quantity_, 15u);
+	EXPECT_EQ(deltas[3].count_, 2u);
+	EXPECT_EQ(deltas[4].quantity_, 11u);
+}
+
+TEST(JournalTests, DecodesToLogMessages)
+{
+	const auto path = std::filesystem::temp_directory_path() / "OrderBookTests" / "OrderBook.journal";
+	Journal::Remove(path);
+
+	{
+		// Segments of 4 records, so that the journal rolls over twice
+
+		Journal journal{ path, 4 };
+		OrderBook orderbook{ OrderBookConfig{ .symbolId_ = 3, .journal_ = &journal } };
+
+		orderbook.AddOrderToQueue(1, OrderType::GoodTillCancel, Side::Buy, 100, 10);
+		orderbook.AddOrderToQueue(1, OrderType::GoodTillCancel, Side::Buy, 100, 10);
+		orderbook.AddOrderToQueue(2, OrderType::FillAndKill, Side::Sell, 110, 5);
+		orderbook.AddOrderToQueue(3, OrderType::FillOrKill, Side::Sell, 100, 20);
+		orderbook.ModifyOrderToQueue(1, Side::Buy, 99, 6);
+		orderbook.ModifyOrderToQueue(8, Side::Buy, 99, 6);
+		orderbook.CancelOrderToQueue(1);
+		orderbook.CancelOrderToQueue(9);
+
+		orderbook.Size();
+		journal.Flush();
+	}
+
+	JournalReader reader{ path };
+
+	// Assert
+
+	const std::vector<std::string> expected
+	{
+		"Orderbook initialized.",
+		"1: Order added successfully. Info: { ID: 1, Type: Good Till Cancel, Side: Buy, Price: 100, Quantity: 10 }",
+		"1: Add order request denied. The order already exists.",
+		"2: Add order request denied. Fill and kill order cannot be matched.",
+		"3: Add order request denied. Fill or kill order cannot be filled.",
+		"1: Request to modify order accepted.",
+		"1: Order cancelled successfully. Info: { ID: 1, Type: Good Till Cancel, Side: Buy, Price: 100, Quantity: 10 }",
+		"1: Order added successfully. Info: { ID: 1, Type: Good Till Cancel, Side: Buy, Price: 99, Quantity: 6 }",
+		"8: Modify order request denied. Order does not exist.",
+		"1: Order cancelled successfully. Info: { ID: 1, Type: Good Till Cancel, Side: Buy, Price: 99, Quantity: 6 }",
+		"9: Request to cancel order denied. Order does not exist.",
+		"Orderbook destroyed.",
+	};
+
+	EXPECT_EQ(reader.SegmentCount(), 3u);
+	ASSERT_EQ(reader.Size(), expected.size());
+
+	std::size_t index = 0;
+	std::uint64_t lastSequence = 0;
+	reader.ForEachRecord([&](const JournalRecord& record)
+		{
+			EXPECT_EQ(FormatJournalMessage(record), expected[index++]);
+			EXPECT_EQ(record.symbolId_, 3u);
+			EXPECT_GE(record.sequence_, lastSequence);
+			lastSequence = record.sequence_;
+		});
+}
+
+TEST(AuditLogTests, UnauditedBooksLeaveTheSharedLoggerAlone)
+{
+	// Inline books log on the calling thread, so a torn down logger throws here
+
+	InlineOrderBook audited;
+
+	{
+		InlineOrderBook unaudited{ OrderBookConfig{ .auditLog_ = false } };
+		EXPECT_FALSE(unaudited.AddOrder(1, OrderType::GoodTillCancel, Side::Buy, 100, 10).IsRejected());
+		EXPECT_FALSE(audited.AddOrder(1, OrderType::GoodTillCancel, Side::Sell, 100, 4).IsRejected());
+	}
+
+	EXPECT_NO_THROW(audited.AddOrder(2, OrderType::GoodTillCancel, Side::Buy, 99, 5));
+	EXPECT_NO_THROW(audited.CancelOrder(1));
+	EXPECT_EQ(audited.Size(), 1u);
+}
+
+TEST(RecoveryTests, RestoresSnapshotAndReplaysJournalTail)
+{
+	const auto folder = std::filesystem::temp_directory_path() / "OrderBookTests";
+	const auto journalPath = folder / "Recovery.journal";
+	const auto snapshotPath = folder / "Recovery.snapshot";
+	const auto recoveredJournalPath = folder / "Recovered.journal";
+	const auto recoveredSnapshotPath = folder / "Recovered.snapshot";
+
+	Journal::Remove(journalPath);
+	Journal::Remove(recoveredJournalPath);
+
+	Journal journal{ journalPath };
+	OrderBook orderbook{ OrderBookConfig{ .symbolId_ = 5, .journal_ = &journal } };
+
+	orderbook.AddOrderToQueue(1, OrderType::GoodTillCancel, Side::Buy, 100, 10);
+	orderbook.AddOrderToQueue(2, OrderType::GoodTillCancel, Side::Buy, 100, 5);
+	orderbook.AddOrderToQueue(3, OrderType::GoodTillCancel, Side::Buy, 99, 7);
+	orderbook.AddOrderToQueue(4, OrderType::GoodTillCancel, Side::Sell, 105, 8);
+	orderbook.AddOrderToQueue(5, OrderType::GoodTillCancel, Side::Sell, 100, 3);
+
+	orderbook.Size();
+	const auto sequence = orderbook.TakeSnapshot(snapshotPath);
+
+	// Requests after the snapshot are only in the journal
+
+	orderbook.AddOrderToQueue(6, OrderType::FillAndKill, Side::Sell, 99, 30);
+	orderbook.AddOrderToQueue(7, OrderType::GoodTillCancel, Side::Sell, 104, 4);
+	orderbook.ModifyOrderToQueue(4, Side::Sell, 103, 6);
+	orderbook.AddOrderToQueue(8, OrderType::GoodTillCancel, Side::Buy, 95, 2);
+	orderbook.ModifyOrderToQueue(8, Side::Buy, 95, 1);
+	orderbook.CancelOrderToQueue(7);
+	orderbook.AddOrderToQueue(9, OrderType::Market, Side::Buy, 0, 1);
+
+	orderbook.Size();
+	journal.Flush();
+
+	Journal recoveredJournal{ recoveredJournalPath };
+	OrderBook recovered{ OrderBookConfig{ .symbolId_ = 5, .journal_ = &recoveredJournal } };
+	recovered.Recover(snapshotPath, journalPath);
+
+	// A snapshot of the recovered book carries on from the last request recovered
+
+	const auto recoveredSequence = recovered.TakeSnapshot(recoveredSnapshotPath);
+
+	// Assert
+
+	EXPECT_EQ(sequence, 5u);
+	EXPECT_EQ(recoveredSequence, 12u);
+
+	auto expectSameBook = [&](const OrderBook& book)
+		{
+			ASSERT_EQ(book.Size(), orderbook.Size());
+
+			const auto expected = orderbook.GetOrderInfos();
+			const auto actual = book.GetOrderInfos();
+
+			ASSERT_EQ(actual.GetBids().size(), expected.GetBids().size());
+			ASSERT_EQ(actual.GetAsks().size(), expected.GetAsks().size());
+
+			for (std::size_t i = 0; i < expected.GetBids().size(); ++i)
+			{
+				EXPECT_EQ(actual.GetBids()[i].price_, expected.GetBids()[i].price_);
+				EXPECT_EQ(actual.GetBids()[i].quantity_, expected.GetBids()[i].quantity_);
+			}
+
+			for (std::size_t i = 0; i < expected.GetAsks().size(); ++i)
+			{
+				EXPECT_EQ(actual.GetAsks()[i].price_, expected.GetAsks()[i].price_);
+				EXPECT_EQ(actual.GetAsks()[i].quantity_, expected.GetAsks()[i].quantity_);
+			}
+		};
+
+	expectSameBook(recovered);
+
+	// Time priority survives the restart, so both books match alike from here, and
+	// number their requests alike
+
+	for (auto* book : { &orderbook, &recovered })
+	{
+		EXPECT_EQ(book->AddOrderToQueue(10, OrderType::GoodTillCancel, Side::Buy, 95, 5), 13u);
+		book->AddOrderToQueue(11, OrderType::GoodTillCancel, Side::Sell, 95, 1);
+		book->CancelOrderToQueue(8);
+	}
+
+	expectSameBook(recovered);
+
+	// The requests journaled after the second snapshot survive a second restart
+
+	recoveredJournal.Flush();
+
+	OrderBook restarted{ OrderBookConfig{ .symbolId_ = 5 } };
+	restarted.Recover(recoveredSnapshotPath, recoveredJournalPath);
+
+	expectSameBook(restarted);
+}
+
+TEST(RecoveryTests, RestartsOnTheJournalItRecoversFrom)
+{
+	const auto folder = std::filesystem::temp_directory_path() / "OrderBookTests";
+	const auto journalPath = folder / "Restart.journal";
+	const auto snapshotPath = folder / "Restart.snapshot";
+
+	Journal::Remove(journalPath);
+
+	{
+		Journal journal{ journalPath };
+		OrderBook orderbook{ OrderBookConfig{ .symbolId_ = 2, .journal_ = &journal } };
+
+		orderbook.AddOrderToQueue(1, OrderType::GoodTillCancel, Side::Buy, 100, 10);
+		orderbook.AddOrderToQueue(2, OrderType::GoodTillCancel, Side::Sell, 105, 5);
+
+		orderbook.Size();
+		orderbook.TakeSnapshot(snapshotPath);
+
+		orderbook.AddOrderToQueue(3, OrderType::GoodTillCancel, Side::Sell, 101, 4);
+		orderbook.CancelOrderToQueue(1);
+
+		orderbook.Size();
+		journal.Flush();
+	}
+
+	// Reopening the journal keeps the tail written before the restart
+
+	Journal journal{ journalPath };
+	OrderBook restarted{ OrderBookConfig{ .symbolId_ = 2, .journal_ = &journal } };
+	restarted.Recover(snapshotPath, journalPath);
+
+	EXPECT_EQ(restarted.Size(), 2u);
+	EXPECT_EQ(restarted.AddOrderToQueue(4, OrderType::GoodTillCancel, Side::Buy, 101, 1), 5u);
+	EXPECT_EQ(restarted.Size(), 2u);
+
+	journal.Flush();
+
+	// Assert
+
+	const auto infos = restarted.GetOrderInfos();
+	EXPECT_TRUE(infos.GetBids().empty());
+	ASSERT_EQ(infos.GetAsks().size(), 2u);
+	EXPECT_EQ(infos.GetAsks()[0].price_, 101);
+	EXPECT_EQ(infos.GetAsks()[0].quantity_, 3u);
+
+	EXPECT_EQ(JournalReader{ journalPath }.SegmentCount(), 2u);
+}
+
+TEST(MarketDataTests, DeltasApplyOnTopOfDepthSnapshot)
+{
+	std::vector<LevelDelta> deltas;
+	MarketDataFeed feed{ [&deltas](std::span<const LevelDelta> batch)
+		{ deltas.insert(deltas.end(), batch.begin(), batch.end()); } };
+
+	OrderBook orderbook{ OrderBookConfig{ .symbolId_ = 2, .marketDataFeed_ = &feed } };
+
+	orderbook.AddOrderToQueue(1, OrderType::GoodTillCancel, Side::Buy, 100, 10);
+	orderbook.AddOrderToQueue(2, OrderType::GoodTillCancel, Side::Buy, 100, 5);
+	orderbook.AddOrderToQueue(3, OrderType::GoodTillCancel, Side::Buy, 98, 7);
+	orderbook.AddOrderToQueue(4, OrderType::GoodTillCancel, Side::Sell, 103, 8);
+
+	orderbook.Size();
+	const auto snapshot = orderbook.GetDepthSnapshot(10);
+
+	orderbook.AddOrderToQueue(5, OrderType::GoodTillCancel, Side::Sell, 100, 12);
+	orderbook.AddOrderToQueue(6, OrderType::FillAndKill, Side::Buy, 104, 10);
+	orderbook.ModifyOrderToQueue(3, Side::Sell, 105, 2);
+	orderbook.CancelOrderToQueue(2);
+	orderbook.AddOrderToQueue(7, OrderType::GoodTillCancel, Side::Buy, 99, 1);
+
+	orderbook.Size();
+	feed.Flush();
+
+	// Rebuild the depth from the snapshot and the deltas published after it
+
+	std::map<Price, DepthLevel, std::greater<Price>> bids;
+	std::map<Price, DepthLevel> asks;
+
+	for (const auto& level : snapshot.bids_) bids[level.price_] = level;
+	for (const auto& level : snapshot.asks_) asks[level.price_] = level;
+
+	for (std::size_t i = 0; i < deltas.size(); ++i)
+	{
+		const auto& delta = deltas[i];
+
+		EXPECT_EQ(delta.sequence_, i + 1);
+		EXPECT_EQ(delta.symbolId_, 2u);
+		if (delta.sequence_ <= snapshot.sequence_) continue;
+
+		auto apply = [&delta](auto& levels)
+			{
+				if (delta.count_ == 0) levels.erase(delta.price_);
+				else levels[delta.price_] = DepthLevel{ delta.price_, delta.quantity_, delta.count_ };
+			};
+
+		if (delta.side_ == Side::Buy) apply(bids);
+		else apply(asks);
+	}
+
+	const auto expected = orderbook.GetDepthSnapshot(10);
+
+	// Assert
+
+	EXPECT_EQ(snapshot.sequence_, 4u);
+	EXPECT_EQ(snapshot.bids_.size(), 2u);
+	EXPECT_EQ(snapshot.bids_.front().quantity_, 15u);
+	EXPECT_EQ(snapshot.bids_.front().count_, 2u);
+	EXPECT_EQ(expected.sequence_, deltas.size());
+
+	auto expectSameLevels = [](const auto& levels, const DepthLevels& expectedLevels)
+		{
+			ASSERT_EQ(levels.size(), expectedLevels.size());
+
+			auto level = levels.begin();
+			for (const auto& expectedLevel : expectedLevels)
+			{
+				EXPECT_EQ(level->second.price_, expectedLevel.price_);
+				EXPECT_EQ(level->second.quantity_, expectedLevel.quantity_);
+				EXPECT_EQ(level->second.count_, expectedLevel.count_);
+				++level;
+			}
+		};
+
+	expectSameLevels(bids, expected.bids_);
+	expectSameLevels(asks, expected.asks_);
+}
+
+TEST(MarketDataTests, AggressiveOrdersOnlyTouchTheOppositeSide)
+{
+	std::vector<LevelDelta> deltas;
+	MarketDataFeed feed{ [&deltas](std::span<const LevelDelta> batch)
+		{ deltas.insert(deltas.end(), batch.begin(), batch.end()); } };
+
+	OrderBook orderbook{ OrderBookConfig{ .marketDataFeed_ = &feed } };
+
+	orderbook.AddOrderToQueue(1, OrderType::GoodTillCancel, Side::Buy, 100, 10);
+	orderbook.AddOrderToQueue(2, OrderType::GoodTillCancel, Side::Buy, 99, 10);
+	orderbook.AddOrderToQueue(3, OrderType::FillAndKill, Side::Sell, 100, 15);
+	orderbook.AddOrderToQueue(4, OrderType::FillOrKill, Side::Sell, 99, 5);
+	orderbook.AddOrderToQueue(5, OrderType::GoodTillCancel, Side::Sell, 99, 8);
+
+	orderbook.Size();
+	feed.Flush();
+
+	// Only the GTC remainder of order 5 reaches the ask side
+
+	std::vector<LevelDelta> askDeltas;
+	std::copy_if(deltas.begin(), deltas.end(), std::back_inserter(askDeltas),
+		[](const LevelDelta& delta) { return delta.side_ == Side::Sell; });
+
+	ASSERT_EQ(askDeltas.size(), 1u);
+	EXPECT_EQ(askDeltas[0].price_, 99);
+	EXPECT_EQ(askDeltas[0].quantity_, 3u);
+	EXPECT_EQ(askDeltas[0].count_, 1u);
+
+	const auto infos = orderbook.GetOrderInfos();
+	EXPECT_EQ(orderbook.Size(), 1u);
+	EXPECT_TRUE(infos.GetBids().empty());
+	ASSERT_EQ(infos.GetAsks().size(), 1u);
+	EXPECT_EQ(infos.GetAsks()[0].quantity_, 3u);
+}
+
+TEST(PriceLevelsTests, EmptiedLevelsAreSkippedAndRevived)
+{
+	InlineOrderBook orderbook{ OrderBookConfig{ .levelStorage_ = LevelStorage::Map } };
+
+	// Rest and cancel bids at more prices than the map keeps dormant, leaving a single
+	// live level below them
+
+	orderbook.AddOrder(1, OrderType::GoodTillCancel, Side::Buy, 50, 5);
+	for (OrderId id = 2; id < 22; ++id)
+	{
+		orderbook.AddOrder(id, OrderType::GoodTillCancel, Side::Buy, static_cast<Price>(80 + id), 5);
+		orderbook.CancelOrder(id);
+	}
+
+	auto infos = orderbook.GetOrderInfos();
+	ASSERT_EQ(infos.GetBids().size(), 1u);
+	EXPECT_EQ(infos.GetBids()[0].price_, 50);
+
+	// A sell at the emptied prices only trades with the live level
+
+	const auto& result = orderbook.AddOrder(30, OrderType::FillAndKill, Side::Sell, 50, 3);
+	ASSERT_EQ(result.trades_.size(), 1u);
+	EXPECT_EQ(result.trades_[0].GetBidTrade().orderId_, 1u);
+
+	// Orders revive dormant and evicted levels alike
+
+	orderbook.AddOrder(31, OrderType::GoodTillCancel, Side::Buy, 101, 4);
+	orderbook.AddOrder(32, OrderType::GoodTillCancel, Side::Buy, 82, 6);
+
+	infos = orderbook.GetOrderInfos();
+	ASSERT_EQ(infos.GetBids().size(), 3u);
+	EXPECT_EQ(infos.GetBids()[0].price_, 101);
+	EXPECT_EQ(infos.GetBids()[0].quantity_, 4u);
+	EXPECT_EQ(infos.GetBids()[1].price_, 82);
+	EXPECT_EQ(infos.GetBids()[2].quantity_, 2u);
+
+	const auto snapshot = orderbook.GetDepthSnapshot(2);
+	ASSERT_EQ(snapshot.bids_.size(), 2u);
+	EXPECT_EQ(snapshot.bids_[1].price_, 82);
+	EXPECT_EQ(snapshot.bids_[1].count_, 1u);
+	EXPECT_EQ(orderbook.Size(), 3u);
+}
+
+TEST(PriceLevelsTests, EmptiedLevelsRecycleTheirNodes)
+{
+	using Bids = PriceMap<std::greater<Price>>;
+
+	Bids map;
+	PriceLadder<std::greater<Price>> ladder{ 16 };
+	Order order{ 1, OrderType::GoodTillCancel, Side::Buy, 0, 1 };
+
+	auto refill = [&order](PriceLevels& levels, Price price)
+		{
+			auto& level = levels.GetOrCreateLevel(price);
+			level.orders_.push_back(&order);
+			level.orders_.erase(&order);
+			levels.EraseLevel(price);
+		};
+
+	// Keep a live level in the ladder window, so that the other prices overflow
+
+	Order resting{ 2, OrderType::GoodTillCancel, Side::Buy, 100, 1 };
+	ladder.GetOrCreateLevel(100).orders_.push_back(&resting);
+
+	// Empty and refill more levels than the map keeps dormant, so that some of them
+	// are evicted, then fewer and more again. The map holds at most its dormant levels
+	// and the ladder none, so neither pool grows past the first rounds
+
+	auto refillRounds = [&](std::size_t prices)
+		{
+			for (std::size_t round = 0; round < 100; ++round)
+			{
+				for (std::size_t i = 0; i < prices; ++i)
+				{
+					refill(map, static_cast<Price>(i));
+					refill(ladder, static_cast<Price>(1'000 + i));
+				}
+			}
+		};
+
+	refillRounds(2 * Bids::MaxDormantLevels);
+
+	const auto mapCapacity = map.Nodes().Capacity();
+	const auto mapInUse = map.Nodes().InUse();
+	const auto ladderCapacity = ladder.OverflowNodes().Capacity();
+	const auto ladderInUse = ladder.OverflowNodes().InUse();
+
+	ASSERT_GT(mapCapacity, 0u);
+	ASSERT_GT(ladderCapacity, 0u);
+
+	for (std::size_t prices : { Bids::MaxDormantLevels / 2, Bids::MaxDormantLevels, 4 * Bids::MaxDormantLevels })
+	{
+		refillRounds(prices);
+
+		EXPECT_EQ(map.Nodes().Capacity(), mapCapacity);
+		EXPECT_LE(map.Nodes().InUse(), mapInUse);
+		EXPECT_EQ(ladder.OverflowNodes().Capacity(), ladderCapacity);
+		EXPECT_EQ(ladder.OverflowNodes().InUse(), ladderInUse);
+	}
+}
+
+TEST(TopOfBookTests, PublishesBestLevelsAfterEachRequest)
+{
+	OrderBook orderbook{ OrderBookConfig{ .publishTopOfBook_ = true } };
+
+	EXPECT_FALSE(orderbook.GetTopOfBook().HasBid());
+	EXPECT_FALSE(orderbook.GetTopOfBook().HasAsk());
+
+	for (OrderId id = 1; id <= 12; ++id)
+		orderbook.AddOrderToQueue(id, OrderType::GoodTillCancel, Side::Buy, 100 - static_cast<Price>(id), 10);
+
+	orderbook.AddOrderToQueue(13, OrderType::GoodTillCancel, Side::Buy, 99, 5);
+	orderbook.AddOrderToQueue(14, OrderType::GoodTillCancel, Side::Sell, 101, 3);
+	orderbook.AddOrderToQueue(15, OrderType::FillAndKill, Side::Sell, 99, 12);
+	orderbook.AddOrderToQueue(16, OrderType::FillAndKill, Side::Sell, 150, 1);
+
+	// Readers do not wait for the queue, drain it before checking the last view
+
+	orderbook.Size();
+	const auto topOfBook = orderbook.GetTopOfBook();
+
+	// Assert
+
+	EXPECT_EQ(topOfBook.sequence_, 15u);
+	EXPECT_EQ(topOfBook.orders_, 13u);
+	EXPECT_EQ(topOfBook.bidLevels_, TopOfBookLevels);
+	EXPECT_EQ(topOfBook.askLevels_, 1u);
+
+	EXPECT_EQ(topOfBook.BestBid().price_, 99);
+	EXPECT_EQ(topOfBook.BestBid().quantity_, 3u);
+	EXPECT_EQ(topOfBook.BestBid().count_, 1u);
+	EXPECT_EQ(topOfBook.bids_[1].price_, 98);
+	EXPECT_EQ(topOfBook.bids_[TopOfBookLevels - 1].price_, 90);
+
+	EXPECT_EQ(topOfBook.BestAsk().price_, 101);
+	EXPECT_EQ(topOfBook.BestAsk().quantity_, 3u);
+}
+
+TEST(TopOfBookTests, ReadersNeverSeeTornViews)
+{
+	OrderBook orderbook{ OrderBookConfig{ .publishTopOfBook_ = true } };
+
+	// Every view must have been published whole, so its levels stay sorted and the
+	// sequence never goes backwards
+
+	std::atomic<bool> done{ false };
+	std::size_t reads = 0;
+	bool consistent = true;
+
+	std::thread reader([&]()
+		{
+			std::uint64_t lastSequence = 0;
+			while (!done.load(std::memory_order_acquire))
+			{
+				const auto topOfBook = orderbook.GetTopOfBook();
+				consistent = consistent && topOfBook.sequence_ >= lastSequence && topOfBook.bidLevels_ <= TopOfBookLevels;
+
+				for (std::uint32_t level = 1; level < topOfBook.bidLevels_; ++level)
+					consistent = consistent && topOfBook.bids_[level - 1].price_ > topOfBook.bids_[level].price_;
+
+				lastSequence = topOfBook.sequence_;
+				++reads;
+			}
+		});
+
+	for (OrderId id = 1; id <= 20'000; ++id)
+	{
+		orderbook.AddOrderToQueue(id, OrderType::GoodTillCancel, Side::Buy, static_cast<Price>(id % 50), 10);
+		if (id % 3 == 0) orderbook.CancelOrderToQueue(id - 1);
+	}
+
+	orderbook.Size();
+	done.store(true, std::memory_order_release);
+	reader.join();
+
+	// Assert
+
+	EXPECT_TRUE(consistent);
+	EXPECT_GT(reads, 0u);
+}
+
+TEST(QueueEventTests, TagsEachRequestWithItsFields)
+{
+	EXPECT_EQ(alignof(QueueEvent), 32u);
+
+	const QueueEvent add{ AddOrderPayload{ 1, OrderType::FillOrKill, Side::Sell, 99, 5, 7 } };
+	const QueueEvent modify{ ModifyOrderPayload{ 2, Side::Buy, 101, 6, 8 } };
+	const QueueEvent cancel{ CancelOrderPayload{ 3, 9 } };
+
+	EXPECT_EQ(add.event_, EventType::AddOrder);
+	EXPECT_EQ(modify.event_, EventType::ModifyOrder);
+	EXPECT_EQ(cancel.event_, EventType::CancelOrder);
+	EXPECT_EQ(cancel.symbolId_, 9u);
+
+	// Copied as plain bytes, as the rings do
+
+	QueueEvent copy;
+	std::memcpy(&copy, &add, sizeof(QueueEvent));
+
+	copy.Visit([](const auto& payload)
+		{
+			using T = std::decay_t<decltype(payload)>;
+			ASSERT_TRUE((std::is_same_v<T, AddOrderPayload>));
+			if constexpr (std::is_same_v<T, AddOrderPayload>)
+			{
+				EXPECT_EQ(payload.orderId_, 1u);
+				EXPECT_EQ(payload.orderType_, OrderType::FillOrKill);
+				EXPECT_EQ(payload.side_, Side::Sell);
+				EXPECT_EQ(payload.price_, 99);
+				EXPECT_EQ(payload.quantity_, 5u);
+				EXPECT_EQ(payload.symbolId_, 7u);
+			}
+		});
+
+	modify.Visit([](const auto& payload)
+		{
+			using T = std::decay_t<decltype(payload)>;
+			ASSERT_TRUE((std::is_same_v<T, ModifyOrderPayload>));
+			if constexpr (std::is_same_v<T, ModifyOrderPayload>)
+			{
+				EXPECT_EQ(payload.orderId_, 2u);
+				EXPECT_EQ(payload.side_, Side::Buy);
+				EXPECT_EQ(payload.price_, 101);
+				EXPECT_EQ(payload.quantity_, 6u);
+			}
+		});
+}
+
+TEST(LatencyHistogramTests, ReportsPercentilesWithinBucketPrecision)
+{
+	LatencyHistogram histogram;
+	EXPECT_EQ(histogram.ValueAtPercentile(50.0), 0u);
+
+	for (std::uint64_t nanoseconds = 1; nanoseconds <= 100'000; ++nanoseconds)
+		histogram.Record(nanoseconds);
+
+	// Assert
+
+	EXPECT_EQ(histogram.Count(), 100'000u);
+	EXPECT_EQ(histogram.Max(), 100'000u);
+	EXPECT_EQ(histogram.ValueAtPercentile(0.1), 100u);
+	EXPECT_NEAR(static_cast<double>(histogram.ValueAtPercentile(50.0)), 50'000.0, 50'000.0 * 0.016);
+	EXPECT_NEAR(static_cast<double>(histogram.ValueAtPercentile(99.9)), 99'900.0, 99'900.0 * 0.016);
+	EXPECT_EQ(histogram.ValueAtPercentile(100.0), 100'000u);
+
+	histogram.Reset();
+	EXPECT_EQ(histogram.Count(), 0u);
+}
+
+TEST(EventFileParserTests, StreamsRequestsInPlace)
+{
+	const auto folder = std::filesystem::temp_directory_path() / "OrderBookTests";
+	const auto path = folder / "Requests.txt";
+	std::filesystem::create_directories(folder);
+
+	// Windows line endings, blank and unknown lines, and a trailing newline
+
+	{
+		std::ofstream file{ path, std::ios::binary };
+		file << "A 1 GoodTillCancel B 100 10\r\n"
+			<< "\r\n"
+			<< "# comment\r\n"
+			<< "A 12345678901 FillOrKill S 101 7\r\n"
+			<< "M 1  S 99 4\r\n"
+			<< "C 12345678901\r\n"
+			<< "R 1 0 1\r\n";
+	}
+
+	const EventFileParser parser{ path };
+	EventInformations events;
+	for (const auto& event : parser)
+		events.push_back(event);
+
+	// Assert
+
+	ASSERT_EQ(events.size(), 4u);
+	EXPECT_EQ(events[0].eventType_, EventType::AddOrder);
+	EXPECT_EQ(events[0].orderType_, OrderType::GoodTillCancel);
+	EXPECT_EQ(events[0].quantity_, 10u);
+	EXPECT_EQ(events[1].orderId_, 12'345'678'901u);
+	EXPECT_EQ(events[1].orderType_, OrderType::FillOrKill);
+	EXPECT_EQ(events[1].side_, Side::Sell);
+	EXPECT_EQ(events[2].eventType_, EventType::ModifyOrder);
+	EXPECT_EQ(events[2].side_, Side::Sell);
+	EXPECT_EQ(events[2].price_, 99);
+	EXPECT_EQ(events[3].eventType_, EventType::CancelOrder);
+
+	const auto result = parser.Result();
+	ASSERT_TRUE(result.has_value());
+	EXPECT_EQ(result->allCount_, 1u);
+	EXPECT_EQ(result->askCount_, 1u);
+
+	OrderBook orderbook;
+	EXPECT_EQ(InputHandler{ }.SubmitEventsFromFile(path, orderbook, 3), 4u);
+	EXPECT_EQ(orderbook.Size(), 1u);
+
+	// Malformed requests
+
+	{
+		std::ofstream file{ path, std::ios::binary };
+		file << "A 1 GoodTillCancel B -100 10\n";
+	}
+
+	const EventFileParser malformed{ path };
+	EXPECT_THROW(malformed.begin(), std::logic_error);
+	EXPECT_FALSE(malformed.Result().has_value());
+}
+
+TEST(EventFileParserTests, RejectsFieldsRunningIntoOtherCharacters)
+{
+	const auto folder = std::filesystem::temp_directory_path() / "OrderBookTests";
+	const auto path = folder / "Malformed.txt";
+	std::filesystem::create_directories(folder);
+
+	// Each field must end at a space or the end of the line
+
+	for (const auto* line : { "A 10x GoodTillCancel B 100 5\n", "M 1 S 99 4x\r\n", "C 7,\n", "A 1 GoodTillCancel B- 100 5\n" })
+	{
+		{
+			std::ofstream file{ path, std::ios::binary };
+			file << line;
+		}
+
+		const EventFileParser parser{ path };
+		EXPECT_THROW(parser.begin(), std::logic_error) << line;
+	}
+}
+
+#if defined(ORDERBOOK_LATENCY_TRACE)
+TEST(LatencyTraceTests, RecordsEveryStageOfQueuedRequests)
+{
+	OrderBook orderbook;
+
+	orderbook.AddOrderToQueue(1, OrderType::GoodTillCancel, Side::Buy, 100, 10);
+	orderbook.AddOrderToQueue(2, OrderType::GoodTillCancel, Side::Sell, 100, 10);
+	orderbook.Size();
+
+	orderbook.HandleEvent(QueueEvent{ CancelOrderPayload{ 3 } });
+
+	// Assert
+
+	const auto& trace = orderbook.GetLatencyTrace();
+	EXPECT_EQ(trace.Histogram(LatencyStage::QueueWait).Count(), 2u);
+	EXPECT_EQ(trace.Histogram(LatencyStage::EndToEnd).Count(), 2u);
+	EXPECT_EQ(trace.Histogram(LatencyStage::Match).Count(), 3u);
+	EXPECT_EQ(trace.Histogram(LatencyStage::Logging).Count(), 3u);
+	EXPECT_GE(trace.Histogram(LatencyStage::EndToEnd).Max(), trace.Histogram(LatencyStage::QueueWait).Max());
+}
+#endif